@@ -1,14 +1,22 @@
 #include <boost/math/distributions.hpp>
+#include <algorithm>
+#include <stdexcept>
 #include "Binomial.h"
+#include "BlackScholes.h"
+#include "LatticeKernels.h"
 
 /**
  * Default constructor for Binomial.
  * Initializes the class with default values.
  */
 Binomial::Binomial()
-        : Option(0, 0, 0, 0, 0), steps(0), upSz(0), downSz(0), upMv(0), downMv(0) {
-    root = new bnNode;
-    root->val = stockPrice;
+        : Option(0, 0, 0, 0, 0), exerciseStyle(ExerciseStyle::European),
+          scheme(LatticeScheme::CoxRossRubinstein), smoothing(false), upSz(0), downSz(0), upMv(0),
+          downMv(0), steps(0), stepSize(0), discount(1) {
+    callValues.assign(1, 0.0);
+    putValues.assign(1, 0.0);
+    stockPrices.assign(1, 0.0);
+    exercisable.assign(1, false);
 }
 
 /**
@@ -21,20 +29,134 @@ Binomial::Binomial()
  * @param time Time until the option's expiration.
  * @param intRate Risk-free interest rate.
  * @param steps Number of steps in the binomial tree.
- * and it calculates the upSize, downSize, and sets the root node to the stockPrice
- * and it calcualtes the stepSize
+ * @param exerciseStyle European or American exercise, an American option can be exercised at
+ * every level of the lattice
+ * @param scheme Parameterization of the lattice.
  */
 Binomial::Binomial(double stockPrice, double volatility, double strikePrice, double time,
-                   double intRate, int steps)
-        : Option(stockPrice, volatility, strikePrice, time, intRate), steps(steps) {
-    upSz = std::exp(volatility * std::sqrt((time) / steps));
-    downSz = 1 / upSz;
-    root = new bnNode;
-    root->val = stockPrice;
-
-    root->left = nullptr;
-    root->right = nullptr;
+                   double intRate, int steps, ExerciseStyle exerciseStyle, LatticeScheme scheme)
+        : Option(stockPrice, volatility, strikePrice, time, intRate),
+          exerciseStyle(exerciseStyle), scheme(scheme), smoothing(false), steps(steps) {
+    if (exerciseStyle == ExerciseStyle::Bermudan) {
+        throw std::invalid_argument("Bermudan options need the constructor taking exercise dates");
+    }
+    initializeLattice();
+}
+
+/**
+ * Constructor for a Bermudan option.
+ * Initializes the lattice and marks the level closest to each exercise date as exercisable.
+ *
+ * @param stockPrice Initial price of the underlying stock.
+ * @param volatility Volatility of the underlying stock.
+ * @param strikePrice Strike price of the option.
+ * @param time Time until the option's expiration.
+ * @param intRate Risk-free interest rate.
+ * @param steps Number of steps in the binomial tree.
+ * @param exerciseDates Times in years from now at which the option can be exercised.
+ * @param scheme Parameterization of the lattice.
+ */
+Binomial::Binomial(double stockPrice, double volatility, double strikePrice, double time,
+                   double intRate, int steps, const std::vector<double>& exerciseDates,
+                   LatticeScheme scheme)
+        : Option(stockPrice, volatility, strikePrice, time, intRate),
+          exerciseDates(exerciseDates), exerciseStyle(ExerciseStyle::Bermudan), scheme(scheme),
+          smoothing(false), steps(steps) {
+    initializeLattice();
+
+    for (double date : exerciseDates) {
+        if (date < 0 || date > time) {
+            throw std::invalid_argument("Bermudan exercise dates must be between now and "
+                                        "expiration");
+        }
+        exercisable[std::min<long>(std::lround(date / stepSize), steps)] = true;
+    }
+}
+
+/**
+ * Calculates the upSize, downSize, the risk neutral move probabilities and the one step
+ * discount factor for the chosen scheme, which are the same at every node of the lattice, and
+ * the stock prices at the terminal nodes.
+ * Every scheme sets the probabilities so the discounted stock price is a martingale, and the
+ * stock price after i upward moves is stockPrice * downSz^steps * (upSz / downSz)^i, so the
+ * prices are generated by repeated multiplication instead of calling exp or pow for every node.
+ * Leisen-Reimer needs an odd number of steps, so an even number is rounded up, and the
+ * exercisable levels are sized after the rounding. Every level is exercisable for an American
+ * option, a Bermudan option marks its dates afterwards.
+ *
+ * @throws std::invalid_argument If the lattice has fewer than one step.
+ */
+void Binomial::initializeLattice() {
+    if (steps < 1) {
+        throw std::invalid_argument("A binomial lattice needs at least one step");
+    }
+    if (scheme == LatticeScheme::LeisenReimer && steps % 2 == 0) {
+        steps++;
+    }
     stepSize = time / steps;
+    double growth = std::exp(intRate * stepSize);
+    double drift = (intRate - volatility * volatility / 2) * stepSize;
+    double spread = volatility * std::sqrt(stepSize);
+
+    switch (scheme) {
+        case LatticeScheme::JarrowRudd:
+            upSz = std::exp(drift + spread);
+            downSz = std::exp(drift - spread);
+            upMv = (growth - downSz) / (upSz - downSz);
+            break;
+        case LatticeScheme::Tian: {
+            double varianceGrowth = std::exp(volatility * volatility * stepSize);
+            double root = std::sqrt(varianceGrowth * varianceGrowth + 2 * varianceGrowth - 3);
+            upSz = 0.5 * growth * varianceGrowth * (varianceGrowth + 1 + root);
+            downSz = 0.5 * growth * varianceGrowth * (varianceGrowth + 1 - root);
+            upMv = (growth - downSz) / (upSz - downSz);
+            break;
+        }
+        case LatticeScheme::LeisenReimer: {
+            double d1 = (std::log(stockPrice / strikePrice) +
+                         (intRate + volatility * volatility / 2) * time) /
+                        (volatility * std::sqrt(time));
+            double d2 = d1 - volatility * std::sqrt(time);
+            double stockMv = peizerPratt(d1);
+            upMv = peizerPratt(d2);
+            upSz = growth * stockMv / upMv;
+            downSz = (growth - upMv * upSz) / (1 - upMv);
+            break;
+        }
+        default:
+            upSz = std::exp(spread);
+            downSz = 1 / upSz;
+            upMv = (growth - downSz) / (upSz - downSz);
+    }
+    downMv = 1 - upMv;
+    discount = 1 / growth;
+
+    callValues.assign(steps + 1, 0.0);
+    putValues.assign(steps + 1, 0.0);
+    stockPrices.resize(steps + 1);
+    exercisable.assign(steps + 1, exerciseStyle == ExerciseStyle::American);
+
+    double price = stockPrice * std::pow(downSz, steps);
+    double upRatio = upSz / downSz;
+    for (int i = 0; i <= steps; i++) {
+        stockPrices[i] = price;
+        price *= upRatio;
+    }
+}
+
+/**
+ * Peizer-Pratt method 2 inversion used by the Leisen-Reimer scheme. Gives the probability of
+ * a binomial distribution with the lattice's number of steps that matches the normal
+ * distribution function at z.
+ *
+ * @param z Point of the standard normal distribution.
+ * @return The matching binomial probability.
+ */
+double Binomial::peizerPratt(double z) const {
+    double n = steps;
+    double scaled = z / (n + 1.0 / 3.0 + 0.1 / (n + 1));
+    double root = 0.5 * std::sqrt(1 - std::exp(-scaled * scaled * (n + 1.0 / 6.0)));
+    return z < 0 ? 0.5 - root : 0.5 + root;
 }
 
 /**
@@ -43,9 +165,11 @@ Binomial::Binomial(double stockPrice, double volatility, double strikePrice, dou
  * @return The calculated price of the call option.
  */
 double Binomial::callOptionPrice() {
-    populateTree(root, 0, stockPrice);
-    calculateCallPayout(root, 0, time);
-    return root->val;
+    if (smoothing) {
+        return richardsonPrice(1.0);
+    }
+    terminalPayout(callValues, 1.0);
+    return backwardInduction(callValues, 1.0, steps);
 }
 
 /**
@@ -54,103 +178,230 @@ double Binomial::callOptionPrice() {
  * @return The calculated price of the put option.
  */
 double Binomial::putOptionPrice() {
-    populateTree(root, 0, stockPrice);
-    calculatePutPayout(root, 0,time);
-    return root->val;
+    if (smoothing) {
+        return richardsonPrice(-1.0);
+    }
+    terminalPayout(putValues, -1.0);
+    return backwardInduction(putValues, -1.0, steps);
 }
 
 /**
- * Populates the binomial tree with nodes representing possible future stock prices.
+ * Computes the prices of the call and the put option in a single pass over the lattice.
+ * With Black-Scholes smoothing each side needs its own smoothed lattices, so they are priced
+ * separately.
  *
- * @param currNode Current node in the tree.
- * @param timeStep Current time step in the tree.
- * @param currPrice Current price of the underlying stock.
+ * @return The calculated prices of the call and the put option.
  */
-void Binomial::populateTree(bnNode *currNode, double timeStep, double currPrice) {
-    currNode->val = currPrice;
-    currNode->left = nullptr;
-    currNode->right = nullptr;
-    if(timeStep >= steps){
-        return;
+CallPut Binomial::callPutPrice() {
+    if (smoothing) {
+        return {richardsonPrice(1.0), richardsonPrice(-1.0)};
+    }
+    terminalPayout(callValues, 1.0);
+    terminalPayout(putValues, -1.0);
+    rollbackCallsPuts(steps, 0);
+    return {callValues[0], putValues[0]};
+}
+
+/**
+ * Computes the call and put prices with their delta, gamma and theta from one induction.
+ * The induction stops at the second and first levels to read their values:
+ * delta is the slope between the two nodes of the first level, gamma the change in slope across
+ * the three nodes of the second level divided by half their spread, and theta the change from
+ * the root to the middle node of the second level over two steps. The middle node has the
+ * root's stock price for Cox-Ross-Rubinstein; for other schemes the difference in stock price
+ * is taken out with delta and gamma first. Smoothing is not used for the Greeks.
+ *
+ * @return The prices and Greeks of the call and the put option.
+ * @throws std::invalid_argument If the lattice has fewer than two steps.
+ */
+LatticeGreeks Binomial::greeks() {
+    if (steps < 2) {
+        throw std::invalid_argument("Lattice Greeks need at least two steps");
     }
+    terminalPayout(callValues, 1.0);
+    terminalPayout(putValues, -1.0);
+
+    // stock prices of the nodes on the first two levels
+    double secondGrowth = std::pow(downSz, 2 - steps);
+    double firstGrowth = std::pow(downSz, 1 - steps);
+    double downDown = stockPrices[0] * secondGrowth;
+    double upDown = stockPrices[1] * secondGrowth;
+    double upUp = stockPrices[2] * secondGrowth;
+    double down = stockPrices[0] * firstGrowth;
+    double up = stockPrices[1] * firstGrowth;
+
+    double callSecond[3], putSecond[3], callFirst[2], putFirst[2];
+    rollbackCallsPuts(steps, 2);
+    std::copy(callValues.begin(), callValues.begin() + 3, callSecond);
+    std::copy(putValues.begin(), putValues.begin() + 3, putSecond);
+    rollbackCallsPuts(2, 1);
+    std::copy(callValues.begin(), callValues.begin() + 2, callFirst);
+    std::copy(putValues.begin(), putValues.begin() + 2, putFirst);
+    rollbackCallsPuts(1, 0);
 
-    currNode->left = new bnNode;
-    currNode->right = new bnNode;
+    LatticeGreeks result{};
+    result.price = {callValues[0], putValues[0]};
 
-    populateTree(currNode->left, timeStep+1,currPrice*downSz);
-    populateTree(currNode->right, timeStep+1,currPrice*upSz);
+    // delta, gamma and theta of one side from its values on the first two levels
+    auto readGreeks = [&](const double* second, const double* first, double root, double& delta,
+                          double& gamma, double& theta) {
+        delta = (first[1] - first[0]) / (up - down);
+        gamma = ((second[2] - second[1]) / (upUp - upDown) -
+                 (second[1] - second[0]) / (upDown - downDown)) / ((upUp - downDown) / 2);
+        double move = upDown - stockPrice;
+        theta = (second[1] - root - delta * move - gamma * move * move / 2) / (2 * stepSize);
+    };
+    readGreeks(callSecond, callFirst, result.price.call, result.delta.call, result.gamma.call,
+               result.theta.call);
+    readGreeks(putSecond, putFirst, result.price.put, result.delta.put, result.gamma.put,
+               result.theta.put);
+    return result;
 }
 
 /**
- * Calculates the payout of a call option.
+ * Turns the Black-Scholes smoothing with Richardson extrapolation on or off. The coarse lattice
+ * is built the first time it is switched on and kept for every later price.
  *
- * @param node Current node in the tree.
- * @param timeStep Current time step in the tree.
- * @param remainingTime Remaining time until the option's expiration.
+ * @param enabled Whether to price with BBSR.
  */
-void Binomial::calculateCallPayout(Binomial::bnNode *node, double timeStep, double remainingTime) {
-    upMv = (std::exp(intRate * remainingTime) - downSz) / (upSz - downSz);
-    downMv = 1 - upMv;
-
-    if(timeStep == steps){
-        node->val = std::max(node->val - strikePrice, 0.0);
+void Binomial::setBlackScholesSmoothing(bool enabled) {
+    smoothing = enabled;
+    if (!enabled || coarseLattice) {
+        return;
+    }
+    int coarseSteps = std::max(steps / 2, 1);
+    if (exerciseStyle == ExerciseStyle::Bermudan) {
+        coarseLattice.reset(new Binomial(stockPrice, volatility, strikePrice, time, intRate,
+                                         coarseSteps, exerciseDates, scheme));
     }
     else {
-        remainingTime -= stepSize;
-        calculateCallPayout(node->left, timeStep + 1, remainingTime);
-        calculateCallPayout(node->right, timeStep + 1, remainingTime);
+        coarseLattice.reset(new Binomial(stockPrice, volatility, strikePrice, time, intRate,
+                                         coarseSteps, exerciseStyle, scheme));
     }
+}
 
-    if(node->left != nullptr && node->right != nullptr) {
-        double expectedValue = upMv * node->left->val + downMv * node->right->val;
-        node->val = std::exp(-intRate * stepSize) * expectedValue;
+/**
+ * Prices with Black-Scholes smoothing on this lattice and on the coarse one, then extrapolates.
+ * The smoothed price converges in 1 / steps without oscillating, so with error c / n on lattices
+ * of n fine and m coarse steps, (n * fine - m * coarse) / (n - m) removes the leading error
+ * term. That is 2 * fine - coarse when m is exactly half of n, and the weights follow the step
+ * counts when Leisen-Reimer has rounded either of them up to odd.
+ *
+ * @param sign 1 for a call, -1 for a put.
+ * @return The extrapolated price.
+ */
+double Binomial::richardsonPrice(double sign) {
+    Binomial& coarse = *coarseLattice;
+    std::vector<double>& values = sign > 0 ? callValues : putValues;
+    std::vector<double>& coarseValues = sign > 0 ? coarse.callValues : coarse.putValues;
+    double fine = smoothedPrice(values, sign);
+    if (coarse.steps >= steps) {
+        return fine;
     }
+    double fineWeight = static_cast<double>(steps) / (steps - coarse.steps);
+    return fineWeight * fine - (fineWeight - 1) * coarse.smoothedPrice(coarseValues, sign);
 }
 
 /**
- * Calculates the payout of a put option.
+ * Prices with the last level of the lattice replaced by Black-Scholes. Over the final step the
+ * option is European, so instead of the payouts at expiration the nodes one step before it take
+ * the closed form price with one step left, which removes the kink of the payout that makes the
+ * plain lattice oscillate. Where the option can be exercised on that level the node keeps the
+ * larger of the Black-Scholes price and exercising.
  *
- * @param node Current node in the tree.
- * @param timeStep Current time step in the tree.
- * @param remainingTime Remaining time until the option's expiration.
+ * @param values Rolling array to work in.
+ * @param sign 1 for a call, -1 for a put.
+ * @return The smoothed price at the root of the lattice.
  */
-void Binomial:: calculatePutPayout(Binomial::bnNode *node, double timeStep, double remainingTime){
-    upMv = (std::exp(intRate*remainingTime )-downSz)/(upSz-downSz);
-    downMv = 1 - upMv;
-    if(timeStep == steps){
-        node->val = std::max(strikePrice - node->val,0.0);
-    }
-    else{
-        remainingTime -=stepSize;
-        calculatePutPayout(node->left,timeStep+1,remainingTime);
-        calculatePutPayout(node->right,timeStep+1,remainingTime);
+double Binomial::smoothedPrice(std::vector<double>& values, double sign) {
+    if (steps < 1) {
+        terminalPayout(values, sign);
+        return values[0];
     }
-    if(node->left != nullptr && node->right!= nullptr) {
-        double expectedValue = upMv * node->left->val + downMv * node->right->val;
-        node->val = std::exp(-intRate * stepSize) * expectedValue;
+
+    int level = steps - 1;
+    double growth = std::pow(downSz, level - steps);
+    for (int i = 0; i <= level; i++) {
+        double price = stockPrices[i] * growth;
+        BlackScholes lastStep(price, volatility, strikePrice, stepSize, intRate);
+        double value = sign > 0 ? lastStep.callOptionPrice() : lastStep.putOptionPrice();
+        if (exercisable[level]) {
+            value = std::max(value, sign * (price - strikePrice));
+        }
+        values[i] = value;
     }
+    return backwardInduction(values, sign, level);
 }
 
 /**
- * Destructor for the Binomial class.
- * Deallocates memory used by the binomial tree.
+ * Rolls the call and put arrays back together between two levels, both reading the same
+ * stock prices on the levels where the option can be exercised.
+ *
+ * @param fromLevel Level the arrays currently hold.
+ * @param toLevel Level to stop at.
  */
-Binomial::~Binomial() {
-    deleteTree(root);
+void Binomial::rollbackCallsPuts(int fromLevel, int toLevel) {
+    double upWeight = discount * upMv;
+    double downWeight = discount * downMv;
+    double* calls = callValues.data();
+    double* puts = putValues.data();
+    const double* prices = stockPrices.data();
+
+    for (int level = fromLevel - 1; level >= toLevel; level--) {
+        if (exercisable[level]) {
+            double growth = std::pow(downSz, level - steps);
+            rollbackExerciseLevel(calls, prices, level + 1, growth, strikePrice, 1.0, upWeight,
+                                  downWeight);
+            rollbackExerciseLevel(puts, prices, level + 1, growth, strikePrice, -1.0, upWeight,
+                                  downWeight);
+        }
+        else {
+            rollbackLevel(calls, level + 1, upWeight, downWeight);
+            rollbackLevel(puts, level + 1, upWeight, downWeight);
+        }
+    }
 }
 
 /**
- * Deletes a node and all its child nodes from the binomial tree.
+ * Fills a rolling array with the payout at expiration.
  *
- * @param node, Node to be deleted.
+ * @param values Array to fill, one value per terminal node.
+ * @param sign 1 for a call payout, -1 for a put payout.
  */
-void Binomial::deleteTree(bnNode* node) {
-    if (node == nullptr) {
-        return;
+void Binomial::terminalPayout(std::vector<double>& values, double sign) {
+    for (int i = 0; i <= steps; i++) {
+        values[i] = std::max(sign * (stockPrices[i] - strikePrice), 0.0);
     }
+}
 
-    deleteTree(node->left);
-    deleteTree(node->right);
+/**
+ * Discounts the expected value of the two children of every node, replacing the values
+ * of a level in place with the values of the level before it. Each level is a flat array,
+ * so the update runs as the vectorized kernel of LatticeKernels.h for the processor.
+ * On levels where the option can be exercised the node keeps the larger of holding and
+ * exercising. Node i of a level has the terminal stock price of node i times
+ * downSz^(level - steps), so the check is the same branch free loop as a European level.
+ *
+ * @param values Array holding the values of the first level, overwritten during the induction.
+ * @param sign 1 for a call, -1 for a put.
+ * @param fromLevel Level the values belong to.
+ * @return The value of the option at the root of the lattice.
+ */
+double Binomial::backwardInduction(std::vector<double>& values, double sign, int fromLevel) {
+    double upWeight = discount * upMv;
+    double downWeight = discount * downMv;
+    double* value = values.data();
+    const double* prices = stockPrices.data();
 
-    delete node;
+    for (int level = fromLevel - 1; level >= 0; level--) {
+        if (exercisable[level]) {
+            double growth = std::pow(downSz, level - steps);
+            rollbackExerciseLevel(value, prices, level + 1, growth, strikePrice, sign, upWeight,
+                                  downWeight);
+        }
+        else {
+            rollbackLevel(value, level + 1, upWeight, downWeight);
+        }
+    }
+    return value[0];
 }
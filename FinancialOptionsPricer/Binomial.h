@@ -1,25 +1,77 @@
 #ifndef OPTIONSTRACKER_BINOMIALOPTION_HPP
 #define OPTIONSTRACKER_BINOMIALOPTION_HPP
 
+#include <memory>
+#include <vector>
 #include "Option.h"
 
+/**
+ * How the move sizes and probabilities of the binomial lattice are chosen. All of them
+ * converge to the Black-Scholes price, but at different rates:
+ * CoxRossRubinstein uses down = 1 / up and oscillates as the number of steps changes,
+ * JarrowRudd centres the moves on the drift so both moves are about equally likely,
+ * Tian matches the first three moments of the stock price over each step,
+ * LeisenReimer places the strike in the middle of the terminal nodes using the Peizer-Pratt
+ * inversion of the normal distribution, which converges smoothly at second order and needs an
+ * odd number of steps.
+ */
+enum class LatticeScheme {
+    CoxRossRubinstein,
+    JarrowRudd,
+    Tian,
+    LeisenReimer
+};
+
+/**
+ * Price, delta, gamma and theta of the call and the put, read off the first levels of the
+ * lattice in a single induction.
+ */
+struct LatticeGreeks {
+    CallPut price;
+    CallPut delta;
+    CallPut gamma;
+    CallPut theta;
+};
+
 /**
  * Binomial option pricing model class that inherits from the Option base class.
  */
 class Binomial: public Option {
 private:
+    // prices whole option chains on the lattice of a Binomial
+    friend class BinomialChain;
+
+    /**
+     * Rolling arrays holding the call and put values of one level of the recombining lattice.
+     * Level n has n + 1 nodes, node i being the price after i upward moves, so a single
+     * array of steps + 1 values is reused for every level while working back to the root.
+     */
+    std::vector<double> callValues;
+    std::vector<double> putValues;
+
+    /**
+     * Stock prices at the terminal nodes of the lattice. The stock price of node i at any
+     * earlier level is the terminal price of node i times a factor that only depends on the
+     * level, so these are shared by the payouts and by every early exercise check.
+     */
+    std::vector<double> stockPrices;
+
     /**
-     * Inner struct representing the nodes of the binomial tree.
-     * Each node has a left and right child, corresponding to the downward and upward moves in the tree,
-     * and a value representing the stock price at that point in time.
+     * Whether the option may be exercised at each level of the lattice.
      */
-    struct bnNode {
-        bnNode* left;
-        bnNode* right;
-        double val;
-    };
+    std::vector<bool> exercisable;
 
-    bnNode* root;  // Root node of the binomial tree, representing the current stock price.
+    std::vector<double> exerciseDates; // Exercise dates of a Bermudan option.
+
+    ExerciseStyle exerciseStyle; // When the option can be exercised.
+    LatticeScheme scheme;        // How the move sizes and probabilities are chosen.
+    bool smoothing;              // Whether to price with Black-Scholes smoothing (BBSR).
+
+    /**
+     * Lattice with about half the steps that BBSR extrapolates against, built once when the
+     * smoothing is switched on.
+     */
+    std::unique_ptr<Binomial> coarseLattice;
 
     double upSz;   // Upward move size.
     double downSz; // Downward move size.
@@ -27,40 +79,66 @@ private:
     double downMv; // Downward move probability.
     int steps;     // Number of time steps in the binomial tree.
     double stepSize; // Size of each step in terms of time.
+    double discount; // Discount factor applied over a single step.
 
     /**
-     * Recursive function to build the binomial tree.
+     * Computes the move sizes, probabilities, terminal stock prices and exercisable levels of
+     * the lattice for the chosen scheme.
      *
-     * @param currNode Current node being populated.
-     * @param timeStep Current time step.
-     * @param currPrice Current stock price.
+     * @throws std::invalid_argument If the lattice has fewer than one step.
      */
-    void populateTree(bnNode* currNode, double timeStep, double currPrice);
+    void initializeLattice();
 
     /**
-     * Recursive function to calculate call option payout.
+     * Peizer-Pratt inversion of the normal distribution used by the Leisen-Reimer scheme.
      *
-     * @param node Node at which to calculate payout.
-     * @param timeStep Time step of node.
-     * @param remTime Remaining time to option expiration.
+     * @param z Point of the standard normal distribution.
+     * @return The binomial probability matching the normal distribution function at z.
      */
-    void calculateCallPayout(bnNode* node, double timeStep, double remTime);
+    double peizerPratt(double z) const;
 
     /**
-     * Recursive function to calculate put option payout.
+     * Fills a rolling array with the payout of the option at expiration.
      *
-     * @param node Node at which to calculate payout.
-     * @param timeStep Time step of node.
-     * @param remainingTime Remaining time to option expiration.
+     * @param values Array to fill, one value per terminal node.
+     * @param sign 1 for a call payout, -1 for a put payout.
      */
-    void calculatePutPayout(bnNode* node, double timeStep, double remainingTime);
+    void terminalPayout(std::vector<double>& values, double sign);
 
     /**
-     * Recursive function to delete the binomial tree.
+     * Works a rolling array back from expiration to the present one level at a time.
      *
-     * @param node Node at which to start deletion.
+     * @param values Values of the level the induction starts from, overwritten by the induction.
+     * @param sign 1 for a call, -1 for a put, used for the value of exercising early.
+     * @param fromLevel Level of the lattice the values belong to.
+     * @return The value at the root node.
      */
-    void deleteTree(bnNode* node);
+    double backwardInduction(std::vector<double>& values, double sign, int fromLevel);
+
+    /**
+     * Rolls the call and put arrays back together from one level to an earlier one.
+     *
+     * @param fromLevel Level of the lattice the arrays hold.
+     * @param toLevel Level to stop at.
+     */
+    void rollbackCallsPuts(int fromLevel, int toLevel);
+
+    /**
+     * Prices on this lattice with the values one step before expiration given by Black-Scholes.
+     *
+     * @param values Rolling array to work in.
+     * @param sign 1 for a call, -1 for a put.
+     * @return The smoothed value at the root node.
+     */
+    double smoothedPrice(std::vector<double>& values, double sign);
+
+    /**
+     * Richardson extrapolation of the smoothed prices on this lattice and on the coarse one.
+     *
+     * @param sign 1 for a call, -1 for a put.
+     * @return The extrapolated price.
+     */
+    double richardsonPrice(double sign);
 
 public:
     using Option::Option;
@@ -79,28 +157,77 @@ public:
      * @param time Option time to expiration.
      * @param intRate Risk-free interest rate.
      * @param steps Number of time steps in the binomial tree.
+     * @param exerciseStyle European or American exercise.
+     * @param scheme Parameterization of the lattice, Leisen-Reimer rounds steps up to odd.
+     * @throws std::invalid_argument If steps is below 1, or for Bermudan exercise, which needs
+     * the constructor taking exercise dates.
      */
     Binomial(double stockPrice, double volatility, double strikePrice, double time, double intRate,
-             int steps);
+             int steps, ExerciseStyle exerciseStyle = ExerciseStyle::European,
+             LatticeScheme scheme = LatticeScheme::CoxRossRubinstein);
 
     /**
-     * Calculate the price of a European call option using the binomial model.
+     * Constructor for a Bermudan option that can be exercised on the given dates.
+     * Each date is moved to the nearest level of the lattice.
+     *
+     * @param stockPrice Initial stock price.
+     * @param volatility Stock price volatility.
+     * @param strikePrice Option strike price.
+     * @param time Option time to expiration.
+     * @param intRate Risk-free interest rate.
+     * @param steps Number of time steps in the binomial tree.
+     * @param exerciseDates Times in years from now at which the option can be exercised.
+     * @param scheme Parameterization of the lattice, Leisen-Reimer rounds steps up to odd.
+     * @throws std::invalid_argument If steps is below 1 or a date is before now or after
+     * expiration.
+     */
+    Binomial(double stockPrice, double volatility, double strikePrice, double time, double intRate,
+             int steps, const std::vector<double>& exerciseDates,
+             LatticeScheme scheme = LatticeScheme::CoxRossRubinstein);
+
+    /**
+     * Calculate the price of a call option using the binomial model.
      *
      * @return The price of the call option.
      */
     double callOptionPrice() override;
 
     /**
-     * Calculate the price of a European put option using the binomial model.
+     * Calculate the price of a put option using the binomial model.
      *
      * @return The price of the put option.
      */
     double putOptionPrice() override;
 
     /**
-     * Destructor that deletes the binomial tree.
+     * Calculate the call and put prices together. The terminal stock prices are generated once
+     * for both payouts and both arrays are rolled back in the same induction pass.
+     *
+     * @return The prices of the call and the put option.
+     */
+    CallPut callPutPrice() override;
+
+    /**
+     * Switches to Binomial Black-Scholes with Richardson extrapolation (BBSR). The values one
+     * step before expiration come from the Black-Scholes formula instead of the payouts, and the
+     * prices with steps and steps / 2 are extrapolated. For American options this reaches about
+     * four decimals with around a hundred steps, where the plain lattice needs thousands.
+     * Leisen-Reimer rounds the coarse lattice up to an odd number of steps, and the
+     * extrapolation weights follow the actual step counts.
+     *
+     * @param enabled Whether to price with BBSR.
+     */
+    void setBlackScholesSmoothing(bool enabled);
+
+    /**
+     * Calculate the call and put prices with delta, gamma and theta from a single induction,
+     * instead of pricing bumped lattices. The Greeks are read off the first two levels of the
+     * lattice, so they cost about as much as the prices.
+     *
+     * @return The prices and Greeks of the call and the put option.
+     * @throws std::invalid_argument If the lattice has fewer than two steps.
      */
-    ~Binomial();
+    LatticeGreeks greeks();
 
 };
 
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "BinomialChain.h"
+#include "LatticeKernels.h"
+
+/**
+ * Constructor for BinomialChain.
+ * Builds the lattice with the stock price as a placeholder strike.
+ *
+ * @param stockPrice Initial price of the underlying stock.
+ * @param volatility Volatility of the underlying stock.
+ * @param time Time until the options' expiration.
+ * @param intRate Risk-free interest rate.
+ * @param steps Number of steps in the lattice.
+ * @param exerciseStyle European or American exercise.
+ * @param scheme Parameterization of the lattice.
+ */
+BinomialChain::BinomialChain(double stockPrice, double volatility, double time, double intRate,
+                             int steps, ExerciseStyle exerciseStyle, LatticeScheme scheme)
+        : lattice(stockPrice, volatility, stockPrice, time, intRate, steps, exerciseStyle,
+                  scheme) {
+    sumTerminalWeights();
+}
+
+/**
+ * Constructor for a chain of Bermudan options.
+ *
+ * @param stockPrice Initial price of the underlying stock.
+ * @param volatility Volatility of the underlying stock.
+ * @param time Time until the options' expiration.
+ * @param intRate Risk-free interest rate.
+ * @param steps Number of steps in the lattice.
+ * @param exerciseDates Times in years from now at which the options can be exercised.
+ * @param scheme Parameterization of the lattice.
+ */
+BinomialChain::BinomialChain(double stockPrice, double volatility, double time, double intRate,
+                             int steps, const std::vector<double>& exerciseDates,
+                             LatticeScheme scheme)
+        : lattice(stockPrice, volatility, stockPrice, time, intRate, steps, exerciseDates,
+                  scheme) {
+    sumTerminalWeights();
+}
+
+/**
+ * Rejects the Leisen-Reimer scheme, whose lattice is centred on a single strike.
+ * Checks whether the options can be exercised before expiration. If not, sums the discounted
+ * probability of reaching each terminal node, C(steps, i) * upMv^i * downMv^(steps - i) times
+ * the discount over all steps. The weights are computed from logarithms because the powers
+ * alone underflow for thousands of steps.
+ */
+void BinomialChain::sumTerminalWeights() {
+    if (lattice.scheme == LatticeScheme::LeisenReimer) {
+        throw std::invalid_argument("Leisen-Reimer lattices depend on the strike and can't be "
+                                    "shared by a chain");
+    }
+    int steps = lattice.steps;
+    earlyExercise = std::find(lattice.exercisable.begin(), lattice.exercisable.begin() + steps,
+                              true) != lattice.exercisable.begin() + steps;
+    if (earlyExercise) {
+        values.resize((steps + 1) * blockWidth);
+        return;
+    }
+
+    lowerWeights.assign(steps + 2, 0.0);
+    lowerWeightedPrices.assign(steps + 2, 0.0);
+    upperWeights.assign(steps + 2, 0.0);
+    upperWeightedPrices.assign(steps + 2, 0.0);
+
+    double logUp = std::log(lattice.upMv);
+    double logDown = std::log(lattice.downMv);
+    double logScale = std::lgamma(steps + 1.0) + steps * std::log(lattice.discount);
+    std::vector<double> weights(steps + 1);
+    for (int i = 0; i <= steps; i++) {
+        weights[i] = std::exp(logScale - std::lgamma(i + 1.0) - std::lgamma(steps - i + 1.0) +
+                              i * logUp + (steps - i) * logDown);
+    }
+
+    const std::vector<double>& stockPrices = lattice.stockPrices;
+    for (int i = 0; i <= steps; i++) {
+        lowerWeights[i + 1] = lowerWeights[i] + weights[i];
+        lowerWeightedPrices[i + 1] = lowerWeightedPrices[i] + weights[i] * stockPrices[i];
+    }
+    for (int i = steps; i >= 0; i--) {
+        upperWeights[i] = upperWeights[i + 1] + weights[i];
+        upperWeightedPrices[i] = upperWeightedPrices[i + 1] + weights[i] * stockPrices[i];
+    }
+}
+
+/**
+ * Prices the chain. Without early exercise the call pays off on the terminal nodes above the
+ * strike and the put on those below it, so each price comes from the weight sums on either
+ * side of the strike. Otherwise the chain is rolled back a block of strikes at a time, a last
+ * block that is not full repeats its final strike and the extra lanes are ignored.
+ *
+ * @param strikes Strike prices of the chain.
+ * @return The call and put price of each strike.
+ */
+std::vector<CallPut> BinomialChain::price(const std::vector<double>& strikes) {
+    std::vector<CallPut> prices(strikes.size());
+
+    if (!earlyExercise) {
+        const std::vector<double>& stockPrices = lattice.stockPrices;
+        for (std::size_t k = 0; k < strikes.size(); k++) {
+            double strike = strikes[k];
+            // first terminal node whose stock price is above the strike
+            std::size_t split = std::upper_bound(stockPrices.begin(), stockPrices.end(), strike) -
+                                stockPrices.begin();
+            prices[k].call = upperWeightedPrices[split] - strike * upperWeights[split];
+            prices[k].put = strike * lowerWeights[split] - lowerWeightedPrices[split];
+        }
+        return prices;
+    }
+
+    double signs[blockWidth];
+    double signedStrikes[blockWidth];
+
+    for (std::size_t first = 0; first < strikes.size(); first += blockStrikes) {
+        for (int k = 0; k < blockStrikes; k++) {
+            double strike = strikes[std::min(first + k, strikes.size() - 1)];
+            signs[k] = 1.0;
+            signedStrikes[k] = strike;
+            signs[blockStrikes + k] = -1.0;
+            signedStrikes[blockStrikes + k] = -strike;
+        }
+
+        priceBlock(signs, signedStrikes);
+
+        for (std::size_t k = 0; k < blockStrikes && first + k < strikes.size(); k++) {
+            prices[first + k] = {values[k], values[blockStrikes + k]};
+        }
+    }
+    return prices;
+}
+
+/**
+ * Fills the terminal payouts of a block and rolls it back with the interleaved kernels.
+ *
+ * @param signs 1 for the call lanes, -1 for the put lanes.
+ * @param signedStrikes Strike of each lane times its sign.
+ */
+void BinomialChain::priceBlock(const double* signs, const double* signedStrikes) {
+    int steps = lattice.steps;
+    double upWeight = lattice.discount * lattice.upMv;
+    double downWeight = lattice.discount * lattice.downMv;
+    const double* stockPrices = lattice.stockPrices.data();
+    double* node = values.data();
+
+    for (int i = 0; i <= steps; i++, node += blockWidth) {
+        for (int k = 0; k < blockWidth; k++) {
+            node[k] = std::max(signs[k] * stockPrices[i] - signedStrikes[k], 0.0);
+        }
+    }
+
+    for (int level = steps - 1; level >= 0; level--) {
+        if (lattice.exercisable[level]) {
+            double growth = std::pow(lattice.downSz, level - steps);
+            rollbackInterleavedExerciseLevel(values.data(), stockPrices, level + 1, blockWidth,
+                                             signs, signedStrikes, growth, upWeight, downWeight);
+        }
+        else {
+            rollbackInterleavedLevel(values.data(), level + 1, blockWidth, upWeight, downWeight);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef OPTIONSTRACKER_BINOMIALCHAIN_H
+#define OPTIONSTRACKER_BINOMIALCHAIN_H
+
+#include <vector>
+#include "Binomial.h"
+
+/**
+ * Prices a chain of options with the same underlying and expiration but different strikes.
+ * The stock price lattice depends only on the stock price, volatility, interest rate, time
+ * and number of steps, so it is built once and every strike reuses it, only the payouts
+ * differ.
+ *
+ * Without early exercise, rolling a lattice back is a weighted sum of the terminal payouts,
+ * the weight of a node being the discounted probability of reaching it. Building the lattice
+ * also sums these weights, so each strike then costs a binary search.
+ * With early exercise the strikes are rolled back together with their values interleaved in
+ * one array, so each level is a single streaming pass with a SIMD register covering several
+ * strikes.
+ */
+class BinomialChain {
+private:
+    /**
+     * Calls and puts of this many strikes are rolled back together. Each node stores the calls
+     * of the strikes followed by their puts, which fills a whole AVX-512 register or two AVX2
+     * registers.
+     */
+    static constexpr int blockStrikes = 4;
+    static constexpr int blockWidth = 2 * blockStrikes;
+
+    Binomial lattice; // Shared stock price lattice, its strike is not used.
+    bool earlyExercise; // Whether any level before expiration can be exercised.
+
+    /**
+     * Running sums over the terminal nodes of the discounted probability of reaching each node
+     * and of that weight times the node's stock price. The lower sums cover nodes [0, i) and
+     * price puts, the upper sums cover nodes [i, steps] and price calls, so neither is found
+     * by subtracting from a total, which would lose precision far out of the money.
+     */
+    std::vector<double> lowerWeights;
+    std::vector<double> lowerWeightedPrices;
+    std::vector<double> upperWeights;
+    std::vector<double> upperWeightedPrices;
+
+    /**
+     * Interleaved values of one block of strikes, node i of lane k at values[i * blockWidth + k].
+     */
+    std::vector<double> values;
+
+    /**
+     * Computes the weight sums used to price options that are only exercised at expiration.
+     */
+    void sumTerminalWeights();
+
+    /**
+     * Rolls one block of strikes back to the root.
+     *
+     * @param signs 1 for the call lanes, -1 for the put lanes.
+     * @param signedStrikes Strike of each lane times its sign.
+     */
+    void priceBlock(const double* signs, const double* signedStrikes);
+
+public:
+    /**
+     * Builds the lattice shared by the chain.
+     *
+     * @param stockPrice Initial stock price.
+     * @param volatility Stock price volatility.
+     * @param time Time to expiration of the chain.
+     * @param intRate Risk-free interest rate.
+     * @param steps Number of time steps in the lattice.
+     * @param exerciseStyle European or American exercise.
+     * @param scheme Parameterization of the lattice.
+     * @throws std::invalid_argument For the Leisen-Reimer scheme, whose lattice depends on the
+     * strike and so can't be shared, or for Bermudan exercise, which needs the constructor taking
+     * exercise dates.
+     */
+    BinomialChain(double stockPrice, double volatility, double time, double intRate, int steps,
+                  ExerciseStyle exerciseStyle = ExerciseStyle::European,
+                  LatticeScheme scheme = LatticeScheme::CoxRossRubinstein);
+
+    /**
+     * Builds the lattice shared by a chain of Bermudan options.
+     *
+     * @param stockPrice Initial stock price.
+     * @param volatility Stock price volatility.
+     * @param time Time to expiration of the chain.
+     * @param intRate Risk-free interest rate.
+     * @param steps Number of time steps in the lattice.
+     * @param exerciseDates Times in years from now at which the options can be exercised.
+     * @param scheme Parameterization of the lattice.
+     * @throws std::invalid_argument If a date is before now or after expiration, or for the
+     * Leisen-Reimer scheme.
+     */
+    BinomialChain(double stockPrice, double volatility, double time, double intRate, int steps,
+                  const std::vector<double>& exerciseDates,
+                  LatticeScheme scheme = LatticeScheme::CoxRossRubinstein);
+
+    /**
+     * Prices the call and the put of every strike in the chain.
+     *
+     * @param strikes Strike prices of the chain.
+     * @return The call and put price of each strike, in the order of the strikes.
+     */
+    std::vector<CallPut> price(const std::vector<double>& strikes);
+};
+
+#endif //OPTIONSTRACKER_BINOMIALCHAIN_H
@@ -1,5 +1,36 @@
 #include "BlackScholes.h"
-#include <boost/math/distributions.hpp>
+#include <cmath>
+
+void BlackScholes::normalCdfs(double d1, double d2, bool call, bool put, double* cdf) const {
+    double points[] = {d1, d2, -d1, -d2};
+    if (accuracy == NormalAccuracy::Full) {
+        for (int k = call ? 0 : 2; k < (put ? 4 : 2); k++) {
+            cdf[k] = NormalFull::cdf(points[k]);
+        }
+    } else {
+        normalCdf(points, cdf, 4, accuracy);
+    }
+}
+
+CallPut BlackScholes::prices(bool call, bool put) const {
+    double deviation = volatility * std::sqrt(time);
+    double d1 = (std::log(stockPrice / strikePrice) +
+                 time * (intRate + 0.5 * volatility * volatility)) / deviation;
+    double d2 = d1 - deviation;
+    double discountedStrike = strikePrice * std::exp(-intRate * time);
+
+    double cdf[4];
+    normalCdfs(d1, d2, call, put, cdf);
+
+    CallPut result = {0, 0};
+    if (call) {
+        result.call = stockPrice * cdf[0] - discountedStrike * cdf[1];
+    }
+    if (put) {
+        result.put = discountedStrike * cdf[3] - stockPrice * cdf[2];
+    }
+    return result;
+}
 
 /**
  * Computes the price of a call option using the Black-Scholes model.
@@ -7,17 +38,7 @@
  * @return The calculated price of the call option.
  */
 double BlackScholes::callOptionPrice(){
-    double callPrice;
-    double d1 = (log(stockPrice/strikePrice) + time * (intRate+(pow(volatility,2) ) / 2))/
-                (volatility * pow(time,.5));
-    double d2 = d1 - volatility*std::sqrt(time);
-
-    // Call option price formula in Black-Scholes model
-    callPrice = stockPrice * boost::math::cdf(boost::math::normal(),d1) -
-                strikePrice * std::exp(-intRate*time)*
-                boost::math::cdf(boost::math::normal(),d2);
-
-    return callPrice;
+    return prices(true, false).call;
 }
 
 /**
@@ -26,14 +47,49 @@ double BlackScholes::callOptionPrice(){
  * @return The calculated price of the put option.
  */
 double BlackScholes::putOptionPrice(){
-    double putPrice;
-    double d1 = (log(stockPrice/strikePrice) + time * (intRate+(pow(volatility,2) ) / 2))/
-                (volatility * pow(time,.5));
-    double d2 = d1 - volatility*std::sqrt(time);
+    return prices(false, true).put;
+}
+
+/**
+ * Computes the prices of the call and the put together, sharing d1, d2 and the discount.
+ *
+ * @return The calculated prices of the call and the put option.
+ */
+CallPut BlackScholes::callPutPrice(){
+    return prices(true, true);
+}
+
+/**
+ * Computes the prices and Greeks of the call and the put. The put sides use N(-d1) and N(-d2)
+ * rather than 1 - N(d1) and 1 - N(d2), which keeps their precision deep in the money. Gamma,
+ * vega, vanna and volga are the same for both sides.
+ *
+ * @return The prices and Greeks of the call and the put option.
+ */
+BlackScholesGreeks BlackScholes::greeks(){
+    double rootTime = std::sqrt(time);
+    double deviation = volatility * rootTime;
+    double d1 = (std::log(stockPrice / strikePrice) +
+                 time * (intRate + 0.5 * volatility * volatility)) / deviation;
+    double d2 = d1 - deviation;
+    double discountedStrike = strikePrice * std::exp(-intRate * time);
 
-    // Put option price formula in Black-Scholes model
-    putPrice = strikePrice*std::exp(-intRate*time)*boost::math::cdf(boost::math::normal(),-d2) -
-               stockPrice*boost::math::cdf(boost::math::normal(),-d1);
+    double cdf[4];
+    normalCdfs(d1, d2, true, true, cdf);
+    double density = normalPdf(d1, accuracy);
+    double vega = stockPrice * density * rootTime;
+    double decay = -0.5 * stockPrice * density * volatility / rootTime;
 
-    return putPrice;
+    BlackScholesGreeks greeks;
+    greeks.price = {stockPrice * cdf[0] - discountedStrike * cdf[1],
+                    discountedStrike * cdf[3] - stockPrice * cdf[2]};
+    greeks.delta = {cdf[0], -cdf[2]};
+    greeks.gamma.call = greeks.gamma.put = density / (stockPrice * deviation);
+    greeks.vega.call = greeks.vega.put = vega;
+    greeks.theta = {decay - intRate * discountedStrike * cdf[1],
+                    decay + intRate * discountedStrike * cdf[3]};
+    greeks.rho = {time * discountedStrike * cdf[1], -time * discountedStrike * cdf[3]};
+    greeks.vanna.call = greeks.vanna.put = -density * d2 / volatility;
+    greeks.volga.call = greeks.volga.put = vega * d1 * d2 / volatility;
+    return greeks;
 }
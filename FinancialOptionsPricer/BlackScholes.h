@@ -1,19 +1,59 @@
-
 #ifndef OPTIONSTRACKER_BLACKSCHOLES_H
 #define OPTIONSTRACKER_BLACKSCHOLES_H
-#include <boost/math/special_functions.hpp>
-#include <boost/math/distributions.hpp>
+#include "NormalDistribution.h"
 #include "Option.h"
+/**
+ * Price and sensitivities of the call and the put from one evaluation of the formula. Vega,
+ * rho, vanna and volga are per unit of volatility or rate (1.00, not one percent), theta is
+ * the change in value per year as time passes.
+ */
+struct BlackScholesGreeks {
+    CallPut price;
+    CallPut delta;
+    CallPut gamma;
+    CallPut vega;
+    CallPut theta;
+    CallPut rho;
+    CallPut vanna;
+    CallPut volga;
+};
+
 /**
  * This class uses all of the generic Option private variables and does not require anything else
- * to calculate the option pricing.
+ * to calculate the option pricing. The normal distribution is evaluated at a chosen
+ * NormalAccuracy, full double precision unless asked otherwise.
  */
 class BlackScholes : public Option{
 private:
+    NormalAccuracy accuracy;
 
+    /**
+     * Evaluates N(d1), N(d2), N(-d1) and N(-d2) at this pricer's accuracy tier. Full evaluates
+     * the two of each requested side with the standard library, the cheaper tiers evaluate all
+     * four in one register.
+     *
+     * @param cdf Receives the four values, in that order.
+     */
+    void normalCdfs(double d1, double d2, bool call, bool put, double* cdf) const;
+
+    /**
+     * Evaluates the formula. d1, d2 and the discounted strike are computed once for both sides.
+     *
+     * @param call Whether to price the call.
+     * @param put Whether to price the put.
+     * @return The requested prices, 0 for a side not requested.
+     */
+    CallPut prices(bool call, bool put) const;
 
 public:
-    using Option::Option;
+    /**
+     * @param accuracy Accuracy tier of the normal distribution.
+     */
+    BlackScholes(double stockPrice, double volatility, double strikePrice, double time,
+                 double intRate, NormalAccuracy accuracy = NormalAccuracy::Full)
+            : Option(stockPrice, volatility, strikePrice, time, intRate), accuracy(accuracy) { }
+
+    BlackScholes(): accuracy(NormalAccuracy::Full) { }
 
     /**
      * Calculates the call option price using the BlackScholes formula
@@ -26,5 +66,19 @@ public:
      * @return  the value of the put option
      */
     double putOptionPrice() override;
+
+    /**
+     * Calculates both prices from one evaluation of d1 and d2.
+     * @return the values of the call and the put option
+     */
+    CallPut callPutPrice() override;
+
+    /**
+     * Calculates the prices with delta, gamma, vega, theta, rho, vanna and volga of both sides
+     * from one evaluation of d1, d2, N(d1), N(d2), the density at d1 and the discount factor,
+     * instead of revaluing bumped options.
+     * @return the prices and Greeks of the call and the put option
+     */
+    BlackScholesGreeks greeks();
 };
 #endif
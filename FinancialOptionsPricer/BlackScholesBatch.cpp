@@ -0,0 +1,94 @@
+#include "BlackScholesBatch.h"
+#include "BlackScholesKernels.h"
+#include "Simd.h"
+#include "SimdVec.h"
+
+void BlackScholesBatch::addOption(double stockPrice, double volatility, double strikePrice,
+                                  double time, double intRate, OptionType type) {
+    stockPrices.push_back(stockPrice);
+    volatilities.push_back(volatility);
+    strikePrices.push_back(strikePrice);
+    times.push_back(time);
+    intRates.push_back(intRate);
+    types.push_back(type);
+}
+
+void BlackScholesBatch::reserve(std::size_t count) {
+    stockPrices.reserve(count);
+    volatilities.reserve(count);
+    strikePrices.reserve(count);
+    times.reserve(count);
+    intRates.reserve(count);
+    types.reserve(count);
+}
+
+/**
+ * Prices every option of the batch with the kernel of the active SimdLevel.
+ *
+ * @param accuracy Accuracy tier of the normal distribution.
+ * @return Price of each option, in the order they were added.
+ */
+std::vector<double> BlackScholesBatch::prices(NormalAccuracy accuracy) const {
+    std::vector<double> result(size());
+    price(stockPrices.data(), volatilities.data(), strikePrices.data(), times.data(),
+          intRates.data(), types.data(), size(), result.data(), accuracy);
+    return result;
+}
+
+void BlackScholesBatch::price(const double* stockPrices, const double* volatilities,
+                              const double* strikePrices, const double* times,
+                              const double* intRates, const OptionType* types, std::size_t count,
+                              double* prices, NormalAccuracy accuracy) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                      types, count, prices, accuracy);
+            break;
+        case SimdLevel::AVX2:
+            avx2::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                    types, count, prices, accuracy);
+            break;
+        default:
+            scalar::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                      types, count, prices, accuracy);
+    }
+}
+
+void BlackScholesBatch::price(const float* stockPrices, const float* volatilities,
+                              const float* strikePrices, const float* times,
+                              const float* intRates, const OptionType* types, std::size_t count,
+                              float* prices, NormalAccuracy accuracy) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                      types, count, prices, accuracy);
+            break;
+        case SimdLevel::AVX2:
+            avx2::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                    types, count, prices, accuracy);
+            break;
+        default:
+            scalar::priceBlackScholes(stockPrices, volatilities, strikePrices, times, intRates,
+                                      types, count, prices, accuracy);
+    }
+}
+
+namespace scalar {
+    void priceBlackScholes(const double* stockPrices, const double* volatilities,
+                           const double* strikePrices, const double* times, const double* intRates,
+                           const OptionType* types, std::size_t count, double* prices,
+                           NormalAccuracy accuracy) {
+        priceBlackScholesKernels<ScalarVec, ScalarVec>(stockPrices, volatilities, strikePrices,
+                                                       times, intRates, types, count, prices,
+                                                       accuracy);
+    }
+
+    void priceBlackScholes(const float* stockPrices, const float* volatilities,
+                           const float* strikePrices, const float* times, const float* intRates,
+                           const OptionType* types, std::size_t count, float* prices,
+                           NormalAccuracy accuracy) {
+        priceBlackScholesKernels<ScalarFloatVec, ScalarFloatVec>(stockPrices, volatilities,
+                                                                 strikePrices, times, intRates,
+                                                                 types, count, prices, accuracy);
+    }
+}
@@ -0,0 +1,139 @@
+#include "BlackScholesBook.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+BlackScholesBook::BlackScholesBook(NormalAccuracy accuracy)
+        : accuracy(accuracy), taylorTolerance(0), repriced(0) { }
+
+void BlackScholesBook::addOption(double volatility, double strikePrice, double time,
+                                 double intRate, OptionType type) {
+    if (!(volatility > 0) || !(strikePrice > 0) || !(time > 0)) {
+        throw std::invalid_argument("Options in a book need a positive volatility, strike and "
+                                    "time to expiration");
+    }
+    volatilities.push_back(volatility);
+    strikePrices.push_back(strikePrice);
+    times.push_back(time);
+    intRates.push_back(intRate);
+    signs.push_back(type == OptionType::Call ? 1.0 : -1.0);
+    logStrikes.push_back(0);
+    deviations.push_back(0);
+    inverseDeviations.push_back(0);
+    drifts.push_back(0);
+    discountedStrikes.push_back(0);
+    anchorStockPrices.push_back(0);
+    anchorPrices.push_back(0);
+    deltas.push_back(0);
+    gammas.push_back(0);
+    taylorLimits.push_back(0);
+    prices.push_back(0);
+    updateInvariants(size() - 1);
+}
+
+void BlackScholesBook::reserve(std::size_t count) {
+    for (std::vector<double>* values : {&volatilities, &strikePrices, &times, &intRates, &signs,
+                                        &logStrikes, &deviations, &inverseDeviations, &drifts,
+                                        &discountedStrikes, &anchorStockPrices, &anchorPrices,
+                                        &deltas, &gammas, &taylorLimits, &prices}) {
+        values->reserve(count);
+    }
+}
+
+void BlackScholesBook::updateInvariants(std::size_t option) {
+    double volatility = volatilities[option];
+    double time = times[option];
+    double intRate = intRates[option];
+    logStrikes[option] = std::log(strikePrices[option]);
+    deviations[option] = volatility * std::sqrt(time);
+    inverseDeviations[option] = 1 / deviations[option];
+    drifts[option] = time * (intRate + 0.5 * volatility * volatility);
+    discountedStrikes[option] = strikePrices[option] * std::exp(-intRate * time);
+    taylorLimits[option] = 0;
+}
+
+void BlackScholesBook::setVolatility(std::size_t option, double volatility) {
+    if (option >= size()) {
+        throw std::invalid_argument("No option with this index in the book");
+    }
+    if (!(volatility > 0)) {
+        throw std::invalid_argument("Options in a book need a positive volatility");
+    }
+    volatilities[option] = volatility;
+    updateInvariants(option);
+}
+
+void BlackScholesBook::setTaylorTolerance(double tolerance) {
+    if (!(tolerance >= 0)) {
+        throw std::invalid_argument("The Taylor tolerance can't be negative");
+    }
+    taylorTolerance = tolerance;
+    // every option needs a full repricing to record its delta and gamma, or to drop them
+    std::fill(taylorLimits.begin(), taylorLimits.end(), 0.0);
+}
+
+/**
+ * Evaluates the formula for the pending options. The points of both cdfs of all of them are
+ * gathered into one array, with the sign of a put folded in, so a single call of the
+ * vectorized normalCdf evaluates them; sign * (S N(sign d1) - K e^(-rT) N(sign d2)) then needs
+ * no branch on the type. With the Taylor path on, delta is sign N(sign d1) and gamma
+ * n(d1) / (S vol sqrt(T)), which costs one density per repriced option.
+ */
+void BlackScholesBook::repricePending(double stockPrice) {
+    std::size_t count = pending.size();
+    repriced = count;
+    if (count == 0) {
+        return;
+    }
+    double logStock = std::log(stockPrice);
+    points.resize(2 * count);
+    cdfs.resize(2 * count);
+    for (std::size_t k = 0; k < count; k++) {
+        std::size_t i = pending[k];
+        double d1 = (logStock - logStrikes[i] + drifts[i]) * inverseDeviations[i];
+        points[2 * k] = signs[i] * d1;
+        points[2 * k + 1] = signs[i] * (d1 - deviations[i]);
+    }
+    normalCdf(points.data(), cdfs.data(), 2 * count, accuracy);
+
+    for (std::size_t k = 0; k < count; k++) {
+        std::size_t i = pending[k];
+        prices[i] = signs[i] * (stockPrice * cdfs[2 * k] -
+                                discountedStrikes[i] * cdfs[2 * k + 1]);
+        if (taylorTolerance > 0) {
+            anchorStockPrices[i] = stockPrice;
+            anchorPrices[i] = prices[i];
+            deltas[i] = signs[i] * cdfs[2 * k];
+            gammas[i] = normalPdf(points[2 * k], accuracy) * inverseDeviations[i] / stockPrice;
+            taylorLimits[i] = taylorTolerance * deviations[i] * stockPrice;
+        }
+    }
+}
+
+/**
+ * Reprices from delta and gamma each option whose move from its last full repricing is within
+ * its limit, and gathers the rest for the formula. Options that never had a full repricing
+ * have a limit of 0 and always go to the formula.
+ */
+const std::vector<double>& BlackScholesBook::tick(double stockPrice) {
+    if (!(stockPrice > 0)) {
+        throw std::invalid_argument("The stock price must be positive");
+    }
+    pending.clear();
+    if (taylorTolerance > 0) {
+        for (std::size_t i = 0; i < size(); i++) {
+            double move = stockPrice - anchorStockPrices[i];
+            if (std::fabs(move) < taylorLimits[i]) {
+                prices[i] = anchorPrices[i] + move * (deltas[i] + 0.5 * gammas[i] * move);
+            } else {
+                pending.push_back(i);
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < size(); i++) {
+            pending.push_back(i);
+        }
+    }
+    repricePending(stockPrice);
+    return prices;
+}
@@ -0,0 +1,132 @@
+#ifndef OPTIONSTRACKER_BLACKSCHOLESBOOK_H
+#define OPTIONSTRACKER_BLACKSCHOLESBOOK_H
+#include <cstddef>
+#include <vector>
+#include "NormalDistribution.h"
+#include "Option.h"
+
+/**
+ * Book of European options on one stock, repriced with the Black-Scholes formula of
+ * BlackScholes each time the stock price ticks. Between volatility refreshes only the stock
+ * price moves, so everything else the formula needs is worked out once per option when it is
+ * added: ln K, vol sqrt(T), the drift (r + vol^2 / 2) T and the discounted strike K e^(-rT).
+ * A tick then costs one log for the whole book and two normal cdfs per option, evaluated
+ * together with the vectorized normalCdf.
+ *
+ * Optionally a small move reprices from the delta and gamma of the last full repricing,
+ * P + delta dS + gamma dS^2 / 2, with no cdf at all. An option falls back to the formula once
+ * the stock has moved more than a tolerance from where it was last repriced, measured in
+ * standard deviations of the log stock price to expiration: the error of the expansion grows
+ * with the cube of that move, so short dated options, whose gamma changes fastest, fall back
+ * after smaller moves than long dated ones.
+ */
+class BlackScholesBook {
+private:
+    NormalAccuracy accuracy;
+    double taylorTolerance;
+
+    // invariants of each option between volatility refreshes
+    std::vector<double> volatilities;
+    std::vector<double> strikePrices;
+    std::vector<double> times;
+    std::vector<double> intRates;
+    std::vector<double> signs; // 1 for a call, -1 for a put
+    std::vector<double> logStrikes;
+    std::vector<double> deviations;
+    std::vector<double> inverseDeviations;
+    std::vector<double> drifts;
+    std::vector<double> discountedStrikes;
+
+    // state of the last full repricing of each option, for the Taylor path
+    std::vector<double> anchorStockPrices;
+    std::vector<double> anchorPrices;
+    std::vector<double> deltas;
+    std::vector<double> gammas;
+    // largest move from the anchor the Taylor path takes, 0 to reprice the option in full
+    std::vector<double> taylorLimits;
+
+    std::vector<double> prices;
+    std::vector<std::size_t> pending;
+    std::vector<double> points;
+    std::vector<double> cdfs;
+    std::size_t repriced;
+
+    /**
+     * Works out the invariants of one option from its parameters and drops its Taylor state.
+     */
+    void updateInvariants(std::size_t option);
+
+    /**
+     * Prices the pending options with the formula and, when the Taylor path is on, keeps their
+     * delta and gamma at this stock price.
+     */
+    void repricePending(double stockPrice);
+
+public:
+    /**
+     * @param accuracy Accuracy tier of the normal distribution.
+     */
+    explicit BlackScholesBook(NormalAccuracy accuracy = NormalAccuracy::Full);
+
+    /**
+     * Adds an option to the book. Its price is available from the next tick.
+     *
+     * @param volatility Annual volatility of the stock.
+     * @param strikePrice Strike price of the option.
+     * @param time Time to expiration in years.
+     * @param intRate Annual risk-free interest rate.
+     * @param type Whether the option is a call or a put.
+     * @throws std::invalid_argument If the volatility, the strike or the time is not positive.
+     */
+    void addOption(double volatility, double strikePrice, double time, double intRate,
+                   OptionType type);
+
+    /**
+     * Makes room for count options without reallocating while they are added.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @return Number of options in the book.
+     */
+    std::size_t size() const { return signs.size(); }
+
+    /**
+     * Changes the volatility of one option, for volatility refreshes. The option is repriced
+     * in full on the next tick.
+     *
+     * @param option Index of the option, in the order they were added.
+     * @param volatility Annual volatility of the stock.
+     * @throws std::invalid_argument If the index is out of range or the volatility is not
+     * positive.
+     */
+    void setVolatility(std::size_t option, double volatility);
+
+    /**
+     * Turns the delta and gamma path for small moves on or off. Over a random walk of 1e-4
+     * steps the largest error was about 2e-8 of the stock price with tolerance 0.01, 3e-7 with
+     * 0.05 and 3e-6 with 0.2, with well under 1% of the options repriced in full per tick.
+     *
+     * @param tolerance Largest move of the stock from where an option was last repriced in
+     *                  full, in standard deviations vol sqrt(T) of its log price, that is
+     *                  repriced from delta and gamma. 0, the default, always reprices in full.
+     * @throws std::invalid_argument If the tolerance is negative.
+     */
+    void setTaylorTolerance(double tolerance);
+
+    /**
+     * Reprices the book at a new stock price.
+     *
+     * @param stockPrice Current price of the stock.
+     * @return Price of each option, in the order they were added, valid until the next tick.
+     * @throws std::invalid_argument If the stock price is not positive.
+     */
+    const std::vector<double>& tick(double stockPrice);
+
+    /**
+     * @return Number of options the last tick repriced with the formula rather than from delta
+     * and gamma.
+     */
+    std::size_t fullyRepriced() const { return repriced; }
+};
+#endif //OPTIONSTRACKER_BLACKSCHOLESBOOK_H
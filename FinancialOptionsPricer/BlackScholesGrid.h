@@ -0,0 +1,154 @@
+#ifndef OPTIONSTRACKER_BLACKSCHOLESGRID_H
+#define OPTIONSTRACKER_BLACKSCHOLESGRID_H
+#include <cmath>
+#include <string>
+#include <vector>
+#include "Option.h"
+
+/**
+ * Black-Scholes prices looked up on a precomputed grid, for quoting loops that can't afford the
+ * two normal cdfs of the formula. In units of the forward F = S e^(rT) the call is worth
+ * S N(d1) - K e^(-rT) N(d2) = S c(z, s), a function of two variables only: the deviation
+ * s = vol sqrt(T), the square root of the total variance, and the moneyness z = ln(K / F) / s
+ * in deviations. c is smooth over the whole rectangle |z| <= maxMoneyness, 0 <= s <=
+ * maxDeviation, even as s goes to 0 where the payoff's kink would spoil a grid in ln(K / F).
+ *
+ * Each point of the grid holds c and its derivatives dc/dz, dc/ds and d2c/dzds, all computed
+ * from their closed forms, and a lookup evaluates the bicubic Hermite patch matching them at the
+ * four corners of the point's cell. Keeping the four values per point rather than 16
+ * coefficients per cell makes the default grid 1.3 MB instead of 5 MB, small enough to stay in
+ * the level 2 cache of most processors, and a lookup reads two runs of 64 bytes. A call is a
+ * log, a square root and about 30 multiplies and adds; puts follow from put-call parity, which
+ * adds an exp. Options outside the grid, and any with a deviation too small to divide by, are
+ * priced by BlackScholes, which stays the reference.
+ *
+ * The grid can be saved to a file and loaded back without recomputing it. The file holds the
+ * points as raw doubles and is only meant to be read on the machine type that wrote it.
+ */
+class BlackScholesGrid {
+private:
+    int moneynessPoints;
+    int deviationPoints;
+    double maxMoneyness;
+    double maxDeviation;
+    double moneynessScale;  // cells per unit of z
+    double deviationScale;  // cells per unit of s
+    double maxError;
+    // c, dc/dz, dc/ds and d2c/dzds of the point in row (along s) and column (along z) at
+    // points[(row * moneynessPoints + column) * 4], the derivatives scaled to a unit cell
+    std::vector<double> points;
+
+    /**
+     * Fills c and its derivatives at every grid point.
+     */
+    void build();
+
+    /**
+     * Evaluates every cell against the closed form at points between the grid points.
+     *
+     * @return The largest error found, in units of the stock price.
+     */
+    double measureError() const;
+
+    /**
+     * @return c(z, s) from the bicubic Hermite patch of its cell, for points inside the grid.
+     * The patch weighs each corner's value and slopes by the cubic Hermite basis along z and
+     * along s: the values by (1 - t)^2 (1 + 2 t) and t^2 (3 - 2 t) for the corners at 0 and 1,
+     * the slopes by t (1 - t)^2 and t^2 (t - 1).
+     */
+    double interpolate(double z, double s) const {
+        double x = (z + maxMoneyness) * moneynessScale;
+        double y = s * deviationScale;
+        int column = static_cast<int>(x);
+        int row = static_cast<int>(y);
+        column = column < moneynessPoints - 1 ? column : moneynessPoints - 2;
+        row = row < deviationPoints - 1 ? row : deviationPoints - 2;
+        double u = x - column;
+        double v = y - row;
+        double uLeft = 1 - u, vLeft = 1 - v;
+        double valueU0 = uLeft * uLeft * (1 + 2 * u), valueU1 = u * u * (3 - 2 * u);
+        double slopeU0 = u * uLeft * uLeft, slopeU1 = -u * u * uLeft;
+        double valueV0 = vLeft * vLeft * (1 + 2 * v), valueV1 = v * v * (3 - 2 * v);
+        double slopeV0 = v * vLeft * vLeft, slopeV1 = -v * v * vLeft;
+
+        // c and dc/ds along z on the cell's lower and upper edge, from the two corners of each
+        const double* lower = &points[(row * moneynessPoints + column) * 4];
+        const double* upper = lower + moneynessPoints * 4;
+        double lowerValue = lower[0] * valueU0 + lower[4] * valueU1 + lower[1] * slopeU0 +
+                            lower[5] * slopeU1;
+        double lowerSlope = lower[2] * valueU0 + lower[6] * valueU1 + lower[3] * slopeU0 +
+                            lower[7] * slopeU1;
+        double upperValue = upper[0] * valueU0 + upper[4] * valueU1 + upper[1] * slopeU0 +
+                            upper[5] * slopeU1;
+        double upperSlope = upper[2] * valueU0 + upper[6] * valueU1 + upper[3] * slopeU0 +
+                            upper[7] * slopeU1;
+        return lowerValue * valueV0 + upperValue * valueV1 + lowerSlope * slopeV0 +
+               upperSlope * slopeV1;
+    }
+
+public:
+    /**
+     * Builds the grid and measures its error.
+     *
+     * @param moneynessPoints Number of grid points along the moneyness z.
+     * @param deviationPoints Number of grid points along the deviation s = vol sqrt(T).
+     * @param maxMoneyness The grid covers moneyness from -maxMoneyness to maxMoneyness
+     *                     deviations.
+     * @param maxDeviation The grid covers deviations from 0 to maxDeviation.
+     * @throws std::invalid_argument If either count of points is below 2 or either range is
+     * not positive.
+     */
+    explicit BlackScholesGrid(int moneynessPoints = 201, int deviationPoints = 201,
+                              double maxMoneyness = 6, double maxDeviation = 2.5);
+
+    /**
+     * Loads a grid saved by save.
+     *
+     * @param path File to read.
+     * @throws std::invalid_argument If the file can't be read or doesn't hold a grid.
+     */
+    explicit BlackScholesGrid(const std::string& path);
+
+    /**
+     * Writes the grid to a file.
+     *
+     * @param path File to write, replaced if it exists.
+     * @throws std::invalid_argument If the file can't be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Measured bound on the difference from the closed form, in units of the stock price,
+     * found when the grid was built. Each cell is compared with the formula on a 9 by 9 lattice
+     * of points, which includes the centre and the middle of each edge where the error of a
+     * bicubic Hermite patch peaks, and the largest error found is raised by 10% for peaks
+     * between them. It is a measurement, not a proof: a price from the grid is expected, not
+     * guaranteed, to be within errorBound() * S of the formula's. It falls about 16 times with
+     * each doubling of the points: about 1e-6 for 101 by 101 points and 8e-8 for the default
+     * 201 by 201.
+     */
+    double errorBound() const { return maxError; }
+
+    /**
+     * @return Whether the grid covers an option with moneyness z and deviation s, otherwise
+     * price falls back to BlackScholes.
+     */
+    bool covers(double z, double s) const {
+        return s >= 1e-8 && s <= maxDeviation && std::abs(z) <= maxMoneyness;
+    }
+
+    /**
+     * Prices a European option from the grid, or with BlackScholes outside it.
+     *
+     * @param stockPrice Current price of the stock.
+     * @param volatility Annual volatility of the stock.
+     * @param strikePrice Strike price of the option.
+     * @param time Time to expiration in years.
+     * @param intRate Annual risk-free interest rate.
+     * @param type Whether the option is a call or a put.
+     * @return The price of the option.
+     */
+    double price(double stockPrice, double volatility, double strikePrice, double time,
+                 double intRate, OptionType type) const;
+};
+#endif //OPTIONSTRACKER_BLACKSCHOLESGRID_H
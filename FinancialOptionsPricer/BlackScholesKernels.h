@@ -0,0 +1,109 @@
+#ifndef OPTIONSTRACKER_BLACKSCHOLESKERNELS_H
+#define OPTIONSTRACKER_BLACKSCHOLESKERNELS_H
+#include <cstddef>
+#include "Option.h"
+#include "NormalDistribution.h"
+
+// Kernels of each instruction set, picked between by BlackScholesBatch::price.
+namespace scalar {
+    void priceBlackScholes(const double* stockPrices, const double* volatilities,
+                           const double* strikePrices, const double* times, const double* intRates,
+                           const OptionType* types, std::size_t count, double* prices,
+                           NormalAccuracy accuracy);
+    void priceBlackScholes(const float* stockPrices, const float* volatilities,
+                           const float* strikePrices, const float* times, const float* intRates,
+                           const OptionType* types, std::size_t count, float* prices,
+                           NormalAccuracy accuracy);
+}
+namespace avx2 {
+    void priceBlackScholes(const double* stockPrices, const double* volatilities,
+                           const double* strikePrices, const double* times, const double* intRates,
+                           const OptionType* types, std::size_t count, double* prices,
+                           NormalAccuracy accuracy);
+    void priceBlackScholes(const float* stockPrices, const float* volatilities,
+                           const float* strikePrices, const float* times, const float* intRates,
+                           const OptionType* types, std::size_t count, float* prices,
+                           NormalAccuracy accuracy);
+}
+namespace avx512 {
+    void priceBlackScholes(const double* stockPrices, const double* volatilities,
+                           const double* strikePrices, const double* times, const double* intRates,
+                           const OptionType* types, std::size_t count, double* prices,
+                           NormalAccuracy accuracy);
+    void priceBlackScholes(const float* stockPrices, const float* volatilities,
+                           const float* strikePrices, const float* times, const float* intRates,
+                           const OptionType* types, std::size_t count, float* prices,
+                           NormalAccuracy accuracy);
+}
+
+/**
+ * Kernel body, instantiated with the register wrappers of SimdVec.h. Prices options
+ * [begin, end) a register at a time and returns where it stopped, the caller finishes the
+ * remaining options with ScalarVec. With sign 1 for a call and -1 for a put both are
+ * sign * (S N(sign d1) - K e^(-rT) N(sign d2)), so calls and puts share a register. N is
+ * the cdf of the Normal policy from NormalDistribution.h. The arrays hold the lane type of V,
+ * double or float.
+ */
+template<class V, class Normal, class Scalar = typename V::Scalar>
+std::size_t priceBlackScholesKernel(const Scalar* stockPrices, const Scalar* volatilities,
+                                    const Scalar* strikePrices, const Scalar* times,
+                                    const Scalar* intRates, const OptionType* types,
+                                    std::size_t begin, std::size_t end, Scalar* prices) {
+    const V half = V::broadcast(0.5);
+
+    std::size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        Scalar signs[V::width];
+        for (int k = 0; k < V::width; k++) {
+            signs[k] = types[i + k] == OptionType::Call ? 1.0 : -1.0;
+        }
+        const V sign = V::load(signs);
+        const V stockPrice = V::load(stockPrices + i);
+        const V volatility = V::load(volatilities + i);
+        const V strikePrice = V::load(strikePrices + i);
+        const V time = V::load(times + i);
+        const V intRate = V::load(intRates + i);
+
+        V deviation = volatility * sqrt(time);
+        V drift = fmadd(half * volatility, volatility, intRate) * time;
+        V d1 = (simdLog(stockPrice / strikePrice) + drift) / deviation;
+        V d2 = d1 - deviation;
+        V discountedStrike = strikePrice * simdExp(V::broadcast(0.0) - intRate * time);
+        V price = stockPrice * Normal::cdf(sign * d1) - discountedStrike * Normal::cdf(sign * d2);
+        (sign * price).store(prices + i);
+    }
+    return i;
+}
+
+/**
+ * Prices options [0, count) with the kernel of register type V and the options left at the
+ * end with that of Tail, normally ScalarVec, using the Normal policy of the accuracy tier.
+ */
+template<class V, class Tail, class Scalar = typename V::Scalar>
+void priceBlackScholesKernels(const Scalar* stockPrices, const Scalar* volatilities,
+                              const Scalar* strikePrices, const Scalar* times,
+                              const Scalar* intRates, const OptionType* types, std::size_t count,
+                              Scalar* prices, NormalAccuracy accuracy) {
+    std::size_t i;
+    switch (accuracy) {
+        case NormalAccuracy::High:
+            i = priceBlackScholesKernel<V, NormalHigh>(stockPrices, volatilities, strikePrices,
+                                                       times, intRates, types, 0, count, prices);
+            priceBlackScholesKernel<Tail, NormalHigh>(stockPrices, volatilities, strikePrices,
+                                                      times, intRates, types, i, count, prices);
+            break;
+        case NormalAccuracy::Fast:
+            i = priceBlackScholesKernel<V, NormalFast>(stockPrices, volatilities, strikePrices,
+                                                       times, intRates, types, 0, count, prices);
+            priceBlackScholesKernel<Tail, NormalFast>(stockPrices, volatilities, strikePrices,
+                                                      times, intRates, types, i, count, prices);
+            break;
+        default:
+            i = priceBlackScholesKernel<V, NormalFull>(stockPrices, volatilities, strikePrices,
+                                                       times, intRates, types, 0, count, prices);
+            priceBlackScholesKernel<Tail, NormalFull>(stockPrices, volatilities, strikePrices,
+                                                      times, intRates, types, i, count, prices);
+    }
+}
+
+#endif //OPTIONSTRACKER_BLACKSCHOLESKERNELS_H
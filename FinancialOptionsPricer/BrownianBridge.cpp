@@ -0,0 +1,61 @@
+#include "BrownianBridge.h"
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * Point l between the known points j - 1 and k, at times a < t < b, is normal with mean
+ * ((b - t) W(a) + (t - a) W(b)) / (b - a) and variance (t - a)(b - t) / (b - a). The gaps are
+ * bisected in rounds, left to right, so each round halves the widest gaps.
+ */
+BrownianBridge::BrownianBridge(const std::vector<double>& times)
+        : times(times), bridgeIndex(times.size()), leftIndex(times.size()),
+          rightIndex(times.size()), leftWeight(times.size()), rightWeight(times.size()),
+          stdDev(times.size()) {
+    const int n = size();
+    if (n == 0 || !(times[0] > 0)) {
+        throw std::invalid_argument("A Brownian bridge needs positive times");
+    }
+    for (int i = 1; i < n; i++) {
+        if (!(times[i] > times[i - 1])) {
+            throw std::invalid_argument("The times of a Brownian bridge must increase");
+        }
+    }
+
+    std::vector<bool> known(n);
+    known[n - 1] = true;
+    bridgeIndex[0] = n - 1;
+    stdDev[0] = std::sqrt(times[n - 1]);
+    int j = 0;
+    for (int i = 1; i < n; i++) {
+        // the next unknown run [j, k) and the known point k after it
+        while (known[j]) {
+            j = j + 1 < n ? j + 1 : 0;
+        }
+        int k = j;
+        while (!known[k]) {
+            k++;
+        }
+        const int l = j + (k - 1 - j) / 2;
+        known[l] = true;
+        bridgeIndex[i] = l;
+        leftIndex[i] = j;
+        rightIndex[i] = k;
+        const double start = j > 0 ? times[j - 1] : 0;
+        const double gap = times[k] - start;
+        leftWeight[i] = (times[k] - times[l]) / gap;
+        rightWeight[i] = (times[l] - start) / gap;
+        stdDev[i] = std::sqrt((times[l] - start) * (times[k] - times[l]) / gap);
+        j = k + 1 < n ? k + 1 : 0;
+    }
+}
+
+void BrownianBridge::build(const double* normals, double* path) const {
+    const int n = size();
+    path[n - 1] = stdDev[0] * normals[0];
+    for (int i = 1; i < n; i++) {
+        const int j = leftIndex[i];
+        const double left = j > 0 ? leftWeight[i] * path[j - 1] : 0;
+        path[bridgeIndex[i]] = left + rightWeight[i] * path[rightIndex[i]] +
+                               stdDev[i] * normals[i];
+    }
+}
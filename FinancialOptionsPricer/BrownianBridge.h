@@ -0,0 +1,47 @@
+#ifndef OPTIONSTRACKER_BROWNIANBRIDGE_H
+#define OPTIONSTRACKER_BROWNIANBRIDGE_H
+#include <vector>
+
+/**
+ * Brownian bridge construction of a Brownian motion path, in the order of Jackel (2002),
+ * "Monte Carlo methods in finance". The first normal number sets the end of the path, the
+ * second the middle point given both ends, and each next one the middle of the widest gap
+ * left, from its two neighbours. The first few numbers then carry most of the path's variance.
+ *
+ * With quasi-random numbers this matters: the first dimensions of a Sobol sequence are by far
+ * the most evenly spread, and the bridge spends them on the coarse shape of the path that
+ * drives the payoff, leaving the fine detail to the weaker later dimensions.
+ */
+class BrownianBridge {
+private:
+    std::vector<double> times;
+    // point set by each normal number and the neighbours it is set from, the left one counted
+    // from 1 so that 0 is the start of the path
+    std::vector<int> bridgeIndex;
+    std::vector<int> leftIndex;
+    std::vector<int> rightIndex;
+    std::vector<double> leftWeight;
+    std::vector<double> rightWeight;
+    std::vector<double> stdDev;
+
+public:
+    /**
+     * @param times Increasing positive times of the path's points, starting from 0 at time 0.
+     * @throws std::invalid_argument If there are no times or they are not increasing.
+     */
+    explicit BrownianBridge(const std::vector<double>& times);
+
+    /**
+     * Number of points of a path, one normal number each.
+     */
+    int size() const { return static_cast<int>(times.size()); }
+
+    /**
+     * Builds one path.
+     *
+     * @param normals size() independent standard normal numbers, the most important first.
+     * @param path Receives the Brownian motion at each time.
+     */
+    void build(const double* normals, double* path) const;
+};
+#endif //OPTIONSTRACKER_BROWNIANBRIDGE_H
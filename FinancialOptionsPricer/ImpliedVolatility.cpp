@@ -0,0 +1,67 @@
+#include "ImpliedVolatility.h"
+#include "ImpliedVolatilityKernels.h"
+#include "Simd.h"
+#include "SimdVec.h"
+#include "ThreadPool.h"
+
+// Quotes per chunk each thread takes, enough to amortise handing chunks out.
+static constexpr std::size_t impliedVolatilityGrain = 1024;
+
+ImpliedVolatility impliedVolatility(double price, double stockPrice, double strikePrice,
+                                    double time, double intRate, OptionType type) {
+    ImpliedVolatility result;
+    impliedVolatilityKernel<ScalarVec>(&price, &stockPrice, &strikePrice, &time, &intRate, &type,
+                                       0, 1, &result);
+    return result;
+}
+
+void impliedVolatilities(const double* prices, const double* stockPrices,
+                         const double* strikePrices, const double* times, const double* intRates,
+                         const OptionType* types, std::size_t count, ImpliedVolatility* results) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::impliedVolatilities(prices, stockPrices, strikePrices, times, intRates, types,
+                                        count, results);
+            break;
+        case SimdLevel::AVX2:
+            avx2::impliedVolatilities(prices, stockPrices, strikePrices, times, intRates, types,
+                                      count, results);
+            break;
+        default:
+            scalar::impliedVolatilities(prices, stockPrices, strikePrices, times, intRates, types,
+                                        count, results);
+            return;
+    }
+
+    // the polynomial normal distribution loses relative accuracy far in the tails, where the
+    // standard library's may still converge
+    for (std::size_t i = 0; i < count; i++) {
+        if (results[i].status == ImpliedVolatilityStatus::NotConverged) {
+            int iterations = results[i].iterations;
+            results[i] = impliedVolatility(prices[i], stockPrices[i], strikePrices[i], times[i],
+                                           intRates[i], types[i]);
+            results[i].iterations += iterations;
+        }
+    }
+}
+
+void impliedVolatilities(const double* prices, const double* stockPrices,
+                         const double* strikePrices, const double* times, const double* intRates,
+                         const OptionType* types, std::size_t count, ImpliedVolatility* results,
+                         ThreadPool& pool) {
+    pool.parallelFor(count, impliedVolatilityGrain, [&](std::size_t begin, std::size_t end) {
+        impliedVolatilities(prices + begin, stockPrices + begin, strikePrices + begin,
+                            times + begin, intRates + begin, types + begin, end - begin,
+                            results + begin);
+    });
+}
+
+namespace scalar {
+    void impliedVolatilities(const double* prices, const double* stockPrices,
+                             const double* strikePrices, const double* times,
+                             const double* intRates, const OptionType* types, std::size_t count,
+                             ImpliedVolatility* results) {
+        impliedVolatilityKernel<ScalarVec>(prices, stockPrices, strikePrices, times, intRates,
+                                           types, 0, count, results);
+    }
+}
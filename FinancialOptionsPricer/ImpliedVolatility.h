@@ -0,0 +1,85 @@
+#ifndef OPTIONSTRACKER_IMPLIEDVOLATILITY_H
+#define OPTIONSTRACKER_IMPLIEDVOLATILITY_H
+#include <cstddef>
+#include "Option.h"
+
+class ThreadPool;
+
+/**
+ * Outcome of solving for the implied volatility of one quote.
+ */
+enum class ImpliedVolatilityStatus {
+    Converged,
+    // a stock price, strike or time that is not positive, or a price that is not a number
+    InvalidInput,
+    // the price is at or below the option's intrinsic value, which no volatility gives
+    BelowIntrinsic,
+    // the price is at or above the stock price for a call or the discounted strike for a put
+    AboveMaximum,
+    // the iterations did not settle within their limit
+    NotConverged
+};
+
+/**
+ * Implied volatility of a quote with the number of iterations it took and whether it was found.
+ * volatility is NaN unless status is Converged.
+ */
+struct ImpliedVolatility {
+    double volatility;
+    int iterations;
+    ImpliedVolatilityStatus status;
+};
+
+/**
+ * Solves for the implied volatility of one European quote under Black-Scholes, the inverse of
+ * BlackScholes. Each quote is normalised the way Jaeckel's "Let's be rational" does: with the
+ * forward F, x = ln(F / K) and the undiscounted price divided by sqrt(F K), any quote becomes an
+ * out of the money call, subtracting the intrinsic value from in the money quotes. The
+ * normalised price is convex in the total volatility s = vol * sqrt(T) below the inflection
+ * point sqrt(2 |x|) and concave above it. Below it the solver iterates on 1 / ln(price), above
+ * it on ln(maximum - price), both close to linear in s. The initial guess comes from the
+ * inflection point and the points where its tangent meets 0 and the maximum: between them the
+ * volatility is interpolated through the three points, beyond them Jaeckel's lower and upper
+ * maps, which are near linear in the price there, are inverted. Third order Householder steps
+ * then reach full precision in two or three iterations.
+ *
+ * @param price Market price of the option.
+ * @param stockPrice Current price of the stock.
+ * @param strikePrice Strike price of the option.
+ * @param time Time to expiration in years.
+ * @param intRate Annual risk-free interest rate.
+ * @param type Whether the option is a call or a put.
+ * @return The implied volatility, iteration count and status of the quote.
+ */
+ImpliedVolatility impliedVolatility(double price, double stockPrice, double strikePrice,
+                                    double time, double intRate, OptionType type);
+
+/**
+ * Solves for the implied volatilities of many quotes given as a struct of arrays, with the
+ * vectorized kernel of the active SimdLevel. Quotes the vectorized pass leaves unconverged are
+ * solved again one at a time with the more accurate scalar functions.
+ *
+ * @param prices Market price of each option.
+ * @param stockPrices Current price of the stock of each option.
+ * @param strikePrices Strike price of each option.
+ * @param times Time to expiration of each option in years.
+ * @param intRates Annual risk-free interest rate of each option.
+ * @param types Whether each option is a call or a put.
+ * @param count Number of quotes.
+ * @param results Receives the implied volatility, iteration count and status of each quote.
+ */
+void impliedVolatilities(const double* prices, const double* stockPrices,
+                         const double* strikePrices, const double* times, const double* intRates,
+                         const OptionType* types, std::size_t count, ImpliedVolatility* results);
+
+/**
+ * Solves for the implied volatilities of many quotes like the overload above, split between the
+ * threads of a pool.
+ *
+ * @param pool Threads to solve on.
+ */
+void impliedVolatilities(const double* prices, const double* stockPrices,
+                         const double* strikePrices, const double* times, const double* intRates,
+                         const OptionType* types, std::size_t count, ImpliedVolatility* results,
+                         ThreadPool& pool);
+#endif //OPTIONSTRACKER_IMPLIEDVOLATILITY_H
@@ -0,0 +1,276 @@
+#ifndef OPTIONSTRACKER_IMPLIEDVOLATILITYKERNELS_H
+#define OPTIONSTRACKER_IMPLIEDVOLATILITYKERNELS_H
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "ImpliedVolatility.h"
+#include "SimdMath.h"
+
+// Kernels of each instruction set, picked between by impliedVolatilities.
+namespace scalar {
+    void impliedVolatilities(const double* prices, const double* stockPrices,
+                             const double* strikePrices, const double* times,
+                             const double* intRates, const OptionType* types, std::size_t count,
+                             ImpliedVolatility* results);
+}
+namespace avx2 {
+    void impliedVolatilities(const double* prices, const double* stockPrices,
+                             const double* strikePrices, const double* times,
+                             const double* intRates, const OptionType* types, std::size_t count,
+                             ImpliedVolatility* results);
+}
+namespace avx512 {
+    void impliedVolatilities(const double* prices, const double* stockPrices,
+                             const double* strikePrices, const double* times,
+                             const double* intRates, const OptionType* types, std::size_t count,
+                             ImpliedVolatility* results);
+}
+
+// Most Householder steps the solver takes before giving up on a quote.
+constexpr int maxImpliedVolatilityIterations = 12;
+
+// A quote has converged when its last step changed the total volatility by less than this
+// fraction of it. The steps converge cubically, so what is left after such a step is far below
+// double precision.
+constexpr double impliedVolatilityTolerance = 1e-7;
+
+/**
+ * Normalised price of an out of the money call, e^(x/2) N(x/s + s/2) - e^(-x/2) N(x/s - s/2)
+ * with x <= 0 and s the total volatility.
+ */
+template<class V>
+V normalisedCallPrice(V x, V s, V upWeight, V downWeight) {
+    const V h = x / s;
+    const V t = V::broadcast(0.5) * s;
+    return upWeight * simdNormalCdf(h + t) - downWeight * simdNormalCdf(h - t);
+}
+
+/**
+ * Derivative of the normalised price in the total volatility s, the same for calls and puts.
+ */
+template<class V>
+V normalisedVega(V x, V s) {
+    const V h = x / s;
+    const V t = V::broadcast(0.5) * s;
+    return V::broadcast(0.3989422804014327) * simdExp(V::broadcast(-0.5) * fmadd(h, h, t * t));
+}
+
+/**
+ * Cubic Hermite interpolation of the total volatility between the normalised prices b0 and b1,
+ * where it is s0 and s1 with derivatives d0 and d1 in the price.
+ */
+template<class V>
+V hermiteVolatility(V price, V b0, V b1, V s0, V s1, V d0, V d1) {
+    const V one = V::broadcast(1.0);
+    const V width = b1 - b0;
+    const V t = (price - b0) / width;
+    const V t2 = t * t;
+    const V t3 = t2 * t;
+    const V rise = fmadd(V::broadcast(-2.0), t3, V::broadcast(3.0) * t2);
+    return fmadd(s0, one - rise, s1 * rise) +
+           width * fmadd(d0, t3 - (t2 + t2) + t, d1 * (t3 - t2));
+}
+
+/**
+ * Kernel body, instantiated with the register wrappers of SimdVec.h. Solves quotes
+ * [begin, end) a register at a time and returns where it stopped, the caller finishes the
+ * remaining quotes with ScalarVec. A register iterates until all its lanes have converged,
+ * lanes that converge early keep their value and stop counting iterations.
+ */
+template<class V>
+std::size_t impliedVolatilityKernel(const double* prices, const double* stockPrices,
+                                    const double* strikePrices, const double* times,
+                                    const double* intRates, const OptionType* types,
+                                    std::size_t begin, std::size_t end,
+                                    ImpliedVolatility* results) {
+    const V zero = V::broadcast(0.0);
+    const V half = V::broadcast(0.5);
+    const V one = V::broadcast(1.0);
+    const V two = V::broadcast(2.0);
+
+    std::size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        double signs[V::width], valid[V::width];
+        for (int k = 0; k < V::width; k++) {
+            std::size_t quote = i + k;
+            signs[k] = types[quote] == OptionType::Call ? 1.0 : -1.0;
+            valid[k] = stockPrices[quote] > 0 && strikePrices[quote] > 0 && times[quote] > 0 &&
+                       prices[quote] >= 0 && std::isfinite(prices[quote]) &&
+                       std::isfinite(intRates[quote]) ? 1.0 : 0.0;
+        }
+        // invalid lanes solve a harmless quote so they cannot produce NaNs or slow numbers
+        const auto validLane = lessThan(half, V::load(valid));
+        const V sign = V::load(signs);
+        const V stockPrice = select(validLane, V::load(stockPrices + i), one);
+        const V strikePrice = select(validLane, V::load(strikePrices + i), one);
+        const V time = select(validLane, V::load(times + i), one);
+        const V intRate = select(validLane, V::load(intRates + i), zero);
+        const V price = select(validLane, V::load(prices + i), V::broadcast(0.1));
+
+        // normalised quote: x = ln(F / K) and the undiscounted price over sqrt(F K)
+        const V growth = simdExp(intRate * time);
+        const V forward = stockPrice * growth;
+        const V x = simdLog(forward / strikePrice);
+        const V normalisedPrice = price * growth / sqrt(forward * strikePrice);
+        const V halfGrowth = simdExp(half * x);
+        const V intrinsic = max(sign * (halfGrowth - one / halfGrowth), zero);
+        const V maximum = select(lessThan(zero, sign), halfGrowth, one / halfGrowth);
+        const auto aboveIntrinsic = lessThan(intrinsic, normalisedPrice);
+        const auto belowMaximum = lessThan(normalisedPrice, maximum);
+
+        // the same quote as an out of the money call, whose x is never positive; x = 0 is moved
+        // off the money by a negligible amount so the inflection point below stays positive
+        const V outX = min(zero - abs(x), V::broadcast(-1e-100));
+        const V target = normalisedPrice - intrinsic;
+        const V upWeight = simdExp(half * outX);
+        const V downWeight = one / upWeight;
+
+        // the inflection point, where the tangent meets 0 and the maximum, split the guess into
+        // four regions
+        const V inflection = sqrt(V::broadcast(-2.0) * outX);
+        const V inflectionPrice = normalisedCallPrice(outX, inflection, upWeight, downWeight);
+        const V inflectionVega = normalisedVega(outX, inflection);
+        const V lowTangent = inflection - inflectionPrice / inflectionVega;
+        const auto lowPositive = lessThan(zero, lowTangent);
+        const V low = select(lowPositive, lowTangent, inflection);
+        const V lowPrice = normalisedCallPrice(outX, low, upWeight, downWeight);
+        const V lowVega = normalisedVega(outX, low);
+        const V high = inflection + (upWeight - inflectionPrice) / inflectionVega;
+        const V highPrice = normalisedCallPrice(outX, high, upWeight, downWeight);
+        const V highVega = normalisedVega(outX, high);
+
+        // below the low tangent point: Jaeckel's lower map, the price in terms of
+        // f = 2 pi |x| / sqrt(27) * N(-|x| / (sqrt(3) s))^3 which is linear in it near 0
+        const V mapScale = V::broadcast(1.2091995761561452) * abs(outX);
+        const V lowTail = simdNormalCdf(V::broadcast(0.5773502691896258) * outX / low);
+        const V lowMap = mapScale * lowTail * lowTail * lowTail;
+        const V lowFraction = target / lowPrice;
+        const V map = fmadd(lowMap - lowPrice, lowFraction, lowPrice) * lowFraction;
+        const V mapRoot = min(simdExp(V::broadcast(1.0 / 3.0) * simdLog(map / mapScale)),
+                              V::broadcast(0.4999999999));
+        const V lowerGuess = abs(outX) / (V::broadcast(-1.7320508075688772) *
+                                          simdNormalQuantile(mapRoot));
+
+        // between the tangent points: the volatility interpolated through them and the inflection
+        // point, from 0 when the low tangent point is not positive
+        const V midStart = select(lowPositive, lowPrice, zero);
+        const V midVolatility = select(lowPositive, low, zero);
+        const V midSlope = select(lowPositive, one / lowVega, zero);
+        const V lowMidGuess = hermiteVolatility(target, midStart, inflectionPrice, midVolatility,
+                                                inflection, midSlope, one / inflectionVega);
+        const V highMidGuess = hermiteVolatility(target, inflectionPrice, highPrice, inflection,
+                                                 high, one / inflectionVega, one / highVega);
+
+        // above the high tangent point: the upper map N(-s / 2), linear in the price near the
+        // maximum
+        const V upperFraction = (upWeight - target) / (upWeight - highPrice);
+        const V upperGuess = V::broadcast(-2.0) *
+                simdNormalQuantile(simdNormalCdf(V::broadcast(-0.5) * high) * upperFraction);
+
+        const auto lower = lessThan(target, inflectionPrice);
+        V deviation = select(lessThan(target, highPrice), highMidGuess, upperGuess);
+        deviation = select(lower, lowMidGuess, deviation);
+        deviation = select(lessThan(target, lowPrice), select(lowPositive, lowerGuess, deviation),
+                           deviation);
+
+        // below the inflection point the solver iterates on 1 / ln(b), above it on
+        // ln(maximum - b), both close to linear in s
+        const V goal = select(lower, one / simdLog(target), simdLog(upWeight - target));
+        const V otherSign = select(lower, V::broadcast(-1.0), one);
+
+        double finished[V::width];
+        V done = one - V::load(valid);
+        done = select(aboveIntrinsic, done, one);
+        done = select(belowMaximum, done, one);
+        V iterations = zero;
+        // bracket of the root from the sign of the objective, which decreases in s
+        V lowest = zero;
+        V highest = V::broadcast(std::numeric_limits<double>::infinity());
+
+        for (int iteration = 0; iteration < maxImpliedVolatilityIterations; iteration++) {
+            // the price below the inflection point, its distance to the maximum above it
+            const V h = outX / deviation;
+            const V t = half * deviation;
+            const V first = simdNormalCdf(select(lower, h + t, zero - h - t));
+            const V value = fmadd(upWeight, first, otherSign * downWeight * simdNormalCdf(h - t));
+            const V logValue = simdLog(value);
+            const V objective = select(lower, one / logValue, logValue) - goal;
+
+            // the derivatives of the objective in s, relative to the first so none of them
+            // overflow when the price is tiny
+            const V ratio = normalisedVega(outX, deviation) / value;
+            const V curvature = h * h / deviation - V::broadcast(0.25) * deviation;
+            const V twistOfPrice = curvature * curvature -
+                                   V::broadcast(3.0) * h * h / (deviation * deviation) -
+                                   V::broadcast(0.25);
+            const V inverseLog = one / logValue;
+            const V slope = select(lower, zero - ratio * inverseLog * inverseLog, zero - ratio);
+            const V bendOfObjective = select(lower, zero - (logValue + two) * ratio * inverseLog,
+                                             ratio);
+            const V twistOfObjective =
+                    select(lower, two * fmadd(logValue, logValue + V::broadcast(3.0),
+                                              V::broadcast(3.0)) * inverseLog * inverseLog,
+                           two) * ratio * ratio;
+            const V bend = bendOfObjective + curvature;
+            const V twist = fmadd(V::broadcast(3.0) * bendOfObjective, curvature,
+                                  twistOfObjective + twistOfPrice);
+
+            // Householder step of order three, bisecting when it leaves the bracket
+            const V newton = zero - objective / slope;
+            const V sixthTwist = twist * V::broadcast(1.0 / 6.0);
+            const V householder = newton * fmadd(half * bend, newton, one) /
+                                  fmadd(newton, fmadd(sixthTwist, newton, bend), one);
+            lowest = select(lessThan(zero, objective), max(lowest, deviation), lowest);
+            highest = select(lessThan(objective, zero), min(highest, deviation), highest);
+            V next = deviation + householder;
+            const V bisected = select(lessThan(highest, V::broadcast(1e300)),
+                                      half * (lowest + highest), two * deviation);
+            next = select(lessThan(next, lowest), bisected, next);
+            next = select(lessThan(highest, next), bisected, next);
+            next = select(lessThan(zero, next), next, bisected);
+
+            const auto active = lessThan(done, half);
+            iterations = iterations + (one - done);
+            const V step = next - deviation;
+            deviation = select(active, next, deviation);
+            done = select(lessThan(abs(step), V::broadcast(impliedVolatilityTolerance) * deviation),
+                          one, done);
+
+            done.store(finished);
+            bool allDone = true;
+            for (int k = 0; k < V::width; k++) {
+                allDone = allDone && finished[k] > 0.5;
+            }
+            if (allDone) {
+                break;
+            }
+        }
+
+        double solved[V::width], counts[V::width], below[V::width], above[V::width];
+        (deviation / sqrt(time)).store(solved);
+        iterations.store(counts);
+        select(aboveIntrinsic, zero, one).store(below);
+        select(belowMaximum, zero, one).store(above);
+        done.store(finished);
+        for (int k = 0; k < V::width; k++) {
+            ImpliedVolatility& result = results[i + k];
+            result.volatility = std::numeric_limits<double>::quiet_NaN();
+            result.iterations = static_cast<int>(counts[k]);
+            if (valid[k] == 0) {
+                result.status = ImpliedVolatilityStatus::InvalidInput;
+            } else if (below[k] != 0) {
+                result.status = ImpliedVolatilityStatus::BelowIntrinsic;
+            } else if (above[k] != 0) {
+                result.status = ImpliedVolatilityStatus::AboveMaximum;
+            } else if (finished[k] != 0 && std::isfinite(solved[k])) {
+                result.status = ImpliedVolatilityStatus::Converged;
+                result.volatility = solved[k];
+            } else {
+                result.status = ImpliedVolatilityStatus::NotConverged;
+            }
+        }
+    }
+    return i;
+}
+
+#endif //OPTIONSTRACKER_IMPLIEDVOLATILITYKERNELS_H
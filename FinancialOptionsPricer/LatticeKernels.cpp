@@ -0,0 +1,177 @@
+#include "LatticeKernels.h"
+#include "Simd.h"
+#include "SimdVec.h"
+
+void rollbackLevel(double* values, int nodes, double upWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackLevel(values, nodes, upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackLevel(values, nodes, upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackLevel(values, nodes, upWeight, downWeight);
+    }
+}
+
+void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                           double strikePrice, double sign, double upWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                          upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                        upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                          upWeight, downWeight);
+    }
+}
+
+void rollbackLevel(float* values, int nodes, double upWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackLevel(values, nodes, upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackLevel(values, nodes, upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackLevel(values, nodes, upWeight, downWeight);
+    }
+}
+
+void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                           double strikePrice, double sign, double upWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                          upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                        upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackExerciseLevel(values, stockPrices, nodes, growth, strikePrice, sign,
+                                          upWeight, downWeight);
+    }
+}
+
+void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                              double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackInterleavedLevel(values, nodes, width, upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackInterleavedLevel(values, nodes, width, upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackInterleavedLevel(values, nodes, width, upWeight, downWeight);
+    }
+}
+
+void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                      int width, const double* signs, const double* signedStrikes,
+                                      double growth, double upWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackInterleavedExerciseLevel(values, stockPrices, nodes, width, signs,
+                                                     signedStrikes, growth, upWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackInterleavedExerciseLevel(values, stockPrices, nodes, width, signs,
+                                                   signedStrikes, growth, upWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackInterleavedExerciseLevel(values, stockPrices, nodes, width, signs,
+                                                     signedStrikes, growth, upWeight, downWeight);
+    }
+}
+
+void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                            double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackTrinomialLevel(values, nodes, upWeight, middleWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackTrinomialLevel(values, nodes, upWeight, middleWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackTrinomialLevel(values, nodes, upWeight, middleWeight, downWeight);
+    }
+}
+
+void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                    double strikePrice, double sign, double upWeight,
+                                    double middleWeight, double downWeight) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::rollbackTrinomialExerciseLevel(values, stockPrices, nodes, strikePrice, sign,
+                                                   upWeight, middleWeight, downWeight);
+            break;
+        case SimdLevel::AVX2:
+            avx2::rollbackTrinomialExerciseLevel(values, stockPrices, nodes, strikePrice, sign,
+                                                 upWeight, middleWeight, downWeight);
+            break;
+        default:
+            scalar::rollbackTrinomialExerciseLevel(values, stockPrices, nodes, strikePrice, sign,
+                                                   upWeight, middleWeight, downWeight);
+    }
+}
+
+namespace scalar {
+    void rollbackLevel(double* values, int nodes, double upWeight, double downWeight) {
+        rollbackLevelKernel<ScalarVec>(values, 0, nodes, 1, upWeight, downWeight);
+    }
+
+    void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight, double downWeight) {
+        rollbackExerciseLevelKernel<ScalarVec>(values, stockPrices, 0, nodes, growth, strikePrice,
+                                               sign, upWeight, downWeight);
+    }
+
+    void rollbackLevel(float* values, int nodes, double upWeight, double downWeight) {
+        rollbackLevelKernel<ScalarFloatVec>(values, 0, nodes, 1, upWeight, downWeight);
+    }
+
+    void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight,
+                               double downWeight) {
+        rollbackExerciseLevelKernel<ScalarFloatVec>(values, stockPrices, 0, nodes, growth,
+                                                    strikePrice, sign, upWeight, downWeight);
+    }
+
+    void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                                  double downWeight) {
+        rollbackLevelKernel<ScalarVec>(values, 0, nodes * width, width, upWeight, downWeight);
+    }
+
+    void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                          int width, const double* signs,
+                                          const double* signedStrikes, double growth,
+                                          double upWeight, double downWeight) {
+        rollbackInterleavedExerciseLevelKernel<ScalarVec>(values, stockPrices, nodes, width, 0,
+                                                          width, signs, signedStrikes, growth,
+                                                          upWeight, downWeight);
+    }
+
+    void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                                double downWeight) {
+        rollbackTrinomialLevelKernel<ScalarVec>(values, 0, nodes, upWeight, middleWeight,
+                                                downWeight);
+    }
+
+    void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                        double strikePrice, double sign, double upWeight,
+                                        double middleWeight, double downWeight) {
+        rollbackTrinomialExerciseLevelKernel<ScalarVec>(values, stockPrices, 0, nodes, strikePrice,
+                                                        sign, upWeight, middleWeight, downWeight);
+    }
+}
@@ -0,0 +1,322 @@
+#ifndef OPTIONSTRACKER_LATTICEKERNELS_H
+#define OPTIONSTRACKER_LATTICEKERNELS_H
+#include <cmath>
+
+/**
+ * Backward induction over one level of a recombining lattice stored in a flat array.
+ * Node i of the previous level takes the discounted expected value of nodes i and i + 1,
+ * so the level is updated in place from the bottom up and the inner loop is pure streaming
+ * arithmetic. These dispatch to the kernel of the active SimdLevel.
+ */
+
+/**
+ * Rolls one level back: values[i] = upWeight * values[i + 1] + downWeight * values[i].
+ * Values below 1e-300 (1e-20 in the float version) are flushed to zero so they never become
+ * slow denormal numbers.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param upWeight Discounted probability of an upward move.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackLevel(double* values, int nodes, double upWeight, double downWeight);
+
+/**
+ * Rolls one level back like rollbackLevel and keeps the larger of holding the option and
+ * exercising it. The stock price of node i on this level is stockPrices[i] * growth.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param stockPrices Stock prices of the nodes at the terminal level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param growth Factor from the terminal stock prices to the prices on this level.
+ * @param strikePrice Strike price of the option.
+ * @param sign 1 for a call, -1 for a put.
+ * @param upWeight Discounted probability of an upward move.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                           double strikePrice, double sign, double upWeight, double downWeight);
+
+/**
+ * Float versions of rollbackLevel and rollbackExerciseLevel, with twice the values per register.
+ * The parameters stay double, the kernels round them to float and make up for the rounding of
+ * the weights, see weightRounding.
+ */
+void rollbackLevel(float* values, int nodes, double upWeight, double downWeight);
+
+void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                           double strikePrice, double sign, double upWeight, double downWeight);
+
+/**
+ * Rolls one level of an interleaved lattice back. Each node holds width values, one per lane,
+ * stored next to each other, so node i of lane k is values[i * width + k]. Every lane follows
+ * the same stock price lattice, so the update is rollbackLevel with the neighbouring node
+ * width values away.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param width Number of lanes per node.
+ * @param upWeight Discounted probability of an upward move.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                              double downWeight);
+
+/**
+ * Rolls one level of an interleaved lattice back and keeps the larger of holding and
+ * exercising. Lane k is exercised for signs[k] * (stock price - strike), its strike being
+ * signedStrikes[k] / signs[k], so calls and puts on different strikes can share a node.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param stockPrices Stock prices of the nodes at the terminal level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param width Number of lanes per node.
+ * @param signs 1 for a call lane, -1 for a put lane.
+ * @param signedStrikes Strike price of each lane times its sign.
+ * @param growth Factor from the terminal stock prices to the prices on this level.
+ * @param upWeight Discounted probability of an upward move.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                      int width, const double* signs, const double* signedStrikes,
+                                      double growth, double upWeight, double downWeight);
+
+/**
+ * Rolls one level of a trinomial lattice back. Node i of the earlier level has the children
+ * i, i + 1 and i + 2 (down, middle and up) on the later level.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param upWeight Discounted probability of an upward move.
+ * @param middleWeight Discounted probability of staying level.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                            double downWeight);
+
+/**
+ * Rolls one level of a trinomial lattice back and keeps the larger of holding the option and
+ * exercising it.
+ *
+ * @param values Option values of the later level, replaced by those of the earlier level.
+ * @param stockPrices Stock prices of the nodes of the earlier level.
+ * @param nodes Number of nodes of the earlier level.
+ * @param strikePrice Strike price of the option.
+ * @param sign 1 for a call, -1 for a put.
+ * @param upWeight Discounted probability of an upward move.
+ * @param middleWeight Discounted probability of staying level.
+ * @param downWeight Discounted probability of a downward move.
+ */
+void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                    double strikePrice, double sign, double upWeight,
+                                    double middleWeight, double downWeight);
+
+// Kernels of each instruction set, picked between by the functions above.
+namespace scalar {
+    void rollbackLevel(double* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight, double downWeight);
+    void rollbackLevel(float* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight,
+                               double downWeight);
+    void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                                  double downWeight);
+    void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                          int width, const double* signs,
+                                          const double* signedStrikes, double growth,
+                                          double upWeight, double downWeight);
+    void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                                double downWeight);
+    void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                        double strikePrice, double sign, double upWeight,
+                                        double middleWeight, double downWeight);
+}
+namespace avx2 {
+    void rollbackLevel(double* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight, double downWeight);
+    void rollbackLevel(float* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight,
+                               double downWeight);
+    void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                                  double downWeight);
+    void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                          int width, const double* signs,
+                                          const double* signedStrikes, double growth,
+                                          double upWeight, double downWeight);
+    void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                                double downWeight);
+    void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                        double strikePrice, double sign, double upWeight,
+                                        double middleWeight, double downWeight);
+}
+namespace avx512 {
+    void rollbackLevel(double* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight, double downWeight);
+    void rollbackLevel(float* values, int nodes, double upWeight, double downWeight);
+    void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight,
+                               double downWeight);
+    void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                                  double downWeight);
+    void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                          int width, const double* signs,
+                                          const double* signedStrikes, double growth,
+                                          double upWeight, double downWeight);
+    void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                                double downWeight);
+    void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                        double strikePrice, double sign, double upWeight,
+                                        double middleWeight, double downWeight);
+}
+
+/**
+ * Kernel bodies, instantiated with the register wrappers of SimdVec.h. Each processes values
+ * [begin, end) a register at a time and returns where it stopped, the caller finishes the
+ * remaining values with ScalarVec. Reading values[i + stride] before values[i] is overwritten
+ * keeps the in place update correct, since a register only writes below what it reads. The
+ * binomial kernels work on the lane type of V, double or float, whose smallest normal numbers
+ * are about 2e-308 and 1e-38.
+ */
+template<class Scalar>
+constexpr Scalar negligibleValue() {
+    return sizeof(Scalar) == sizeof(float) ? 1e-20 : 1e-300;
+}
+
+/**
+ * Rounding the weights to float moves them by up to 3e-8 the same way at every level, which
+ * over a few thousand levels biases the price by more than all the other rounding together.
+ * The float kernels add back what the rounding took off both weights, applied to the down
+ * value: the two values differ by a fraction of themselves, so the one correction recovers
+ * most of the lost accuracy for one multiply. It is zero for doubles, and for floats when it is
+ * too small to matter: with values flushed below 1e-20, a correction of at least 1e-15 times a
+ * value is never a subnormal number, which would slow the multiply down many times.
+ */
+template<class Scalar>
+Scalar weightRounding(double upWeight, double downWeight) {
+    double rounding = (upWeight - static_cast<Scalar>(upWeight)) +
+                      (downWeight - static_cast<Scalar>(downWeight));
+    return static_cast<Scalar>(std::fabs(rounding) < 1e-15 ? 0.0 : rounding);
+}
+
+template<class V, class Scalar = typename V::Scalar>
+V rollbackNodes(V up, V down, V rounding, V upValues, V downValues) {
+    if constexpr (sizeof(Scalar) == sizeof(float)) {
+        return fmadd(up, upValues, fmadd(down, downValues, rounding * downValues));
+    } else {
+        return fmadd(up, upValues, down * downValues);
+    }
+}
+
+template<class V, class Scalar = typename V::Scalar>
+int rollbackLevelKernel(Scalar* values, int begin, int end, int stride, double upWeight,
+                        double downWeight) {
+    const V up = V::broadcast(static_cast<Scalar>(upWeight));
+    const V down = V::broadcast(static_cast<Scalar>(downWeight));
+    const V rounding = V::broadcast(weightRounding<Scalar>(upWeight, downWeight));
+    const V negligible = V::broadcast(negligibleValue<Scalar>());
+    const V zero = V::broadcast(0.0);
+
+    int i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        V next = rollbackNodes(up, down, rounding, V::load(values + i + stride),
+                               V::load(values + i));
+        select(lessThan(next, negligible), zero, next).store(values + i);
+    }
+    return i;
+}
+
+template<class V, class Scalar = typename V::Scalar>
+int rollbackExerciseLevelKernel(Scalar* values, const Scalar* stockPrices, int begin, int end,
+                                double growth, double strikePrice, double sign, double upWeight,
+                                double downWeight) {
+    const V up = V::broadcast(static_cast<Scalar>(upWeight));
+    const V down = V::broadcast(static_cast<Scalar>(downWeight));
+    const V rounding = V::broadcast(weightRounding<Scalar>(upWeight, downWeight));
+    const V negligible = V::broadcast(negligibleValue<Scalar>());
+    const V zero = V::broadcast(0.0);
+    const V signedGrowth = V::broadcast(static_cast<Scalar>(sign * growth));
+    const V signedStrike = V::broadcast(static_cast<Scalar>(sign * strikePrice));
+
+    int i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        V hold = rollbackNodes(up, down, rounding, V::load(values + i + 1), V::load(values + i));
+        V exercise = signedGrowth * V::load(stockPrices + i) - signedStrike;
+        max(select(lessThan(hold, negligible), zero, hold), exercise).store(values + i);
+    }
+    return i;
+}
+
+template<class V>
+int rollbackTrinomialLevelKernel(double* values, int begin, int end, double upWeight,
+                                 double middleWeight, double downWeight) {
+    const V up = V::broadcast(upWeight);
+    const V middle = V::broadcast(middleWeight);
+    const V down = V::broadcast(downWeight);
+    const V negligible = V::broadcast(1e-300);
+    const V zero = V::broadcast(0.0);
+
+    int i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        V next = fmadd(up, V::load(values + i + 2),
+                       fmadd(middle, V::load(values + i + 1), down * V::load(values + i)));
+        select(lessThan(next, negligible), zero, next).store(values + i);
+    }
+    return i;
+}
+
+template<class V>
+int rollbackTrinomialExerciseLevelKernel(double* values, const double* stockPrices, int begin,
+                                         int end, double strikePrice, double sign,
+                                         double upWeight, double middleWeight,
+                                         double downWeight) {
+    const V up = V::broadcast(upWeight);
+    const V middle = V::broadcast(middleWeight);
+    const V down = V::broadcast(downWeight);
+    const V negligible = V::broadcast(1e-300);
+    const V zero = V::broadcast(0.0);
+    const V signs = V::broadcast(sign);
+    const V signedStrike = V::broadcast(sign * strikePrice);
+
+    int i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        V hold = fmadd(up, V::load(values + i + 2),
+                       fmadd(middle, V::load(values + i + 1), down * V::load(values + i)));
+        V exercise = signs * V::load(stockPrices + i) - signedStrike;
+        max(select(lessThan(hold, negligible), zero, hold), exercise).store(values + i);
+    }
+    return i;
+}
+
+/**
+ * Interleaved exercise kernel over lanes [laneBegin, laneEnd) of every node. Lanes never mix,
+ * so the caller can run the lanes that fill whole registers and the leftover lanes separately.
+ */
+template<class V>
+int rollbackInterleavedExerciseLevelKernel(double* values, const double* stockPrices, int nodes,
+                                           int width, int laneBegin, int laneEnd,
+                                           const double* signs, const double* signedStrikes,
+                                           double growth, double upWeight, double downWeight) {
+    const V up = V::broadcast(upWeight);
+    const V down = V::broadcast(downWeight);
+    const V negligible = V::broadcast(1e-300);
+    const V zero = V::broadcast(0.0);
+
+    int lane = laneBegin;
+    for (; lane + V::width <= laneEnd; lane += V::width) {
+        const V sign = V::load(signs + lane);
+        const V signedStrike = V::load(signedStrikes + lane);
+        double* node = values + lane;
+        for (int i = 0; i < nodes; i++, node += width) {
+            V hold = fmadd(up, V::load(node + width), down * V::load(node));
+            V exercise = fmadd(sign, V::broadcast(stockPrices[i] * growth), zero - signedStrike);
+            max(select(lessThan(hold, negligible), zero, hold), exercise).store(node);
+        }
+    }
+    return lane;
+}
+
+#endif //OPTIONSTRACKER_LATTICEKERNELS_H
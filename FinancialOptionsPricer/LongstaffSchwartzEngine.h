@@ -0,0 +1,239 @@
+#ifndef OPTIONSTRACKER_LONGSTAFFSCHWARTZENGINE_H
+#define OPTIONSTRACKER_LONGSTAFFSCHWARTZENGINE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "PathKernels.h"
+#include "Philox.h"
+#include "PricingEngines.h"
+#include "ThreadPool.h"
+
+/**
+ * Least squares Monte Carlo of Longstaff and Schwartz (2001) for an option that can be
+ * exercised at the end of every step, approaching the American option as the steps get finer.
+ *
+ * The paths are simulated forward and kept, then the exercise decisions are made backward from
+ * expiration. Each path carries the discounted cash flow of the exercise policy found so far;
+ * at each date the cash flows of the paths in the money are regressed on a polynomial in
+ * x = S / K, and a path is exercised when its payoff beats the fitted continuation value.
+ * Only paths in the money enter the regression, the others would never exercise.
+ *
+ * Storing the paths is what bounds the number of paths, so the stock prices are kept as floats,
+ * 4 bytes per path and step: a million paths over 50 dates take 200 MB. Rounding them to float
+ * moves a payoff by about 1e-7 of the stock price, far below the estimate's standard error,
+ * while the cash flows and the regressions stay double.
+ *
+ * The polynomial's normal equations only need the power sums of x up to twice the degree,
+ * the matrix being sum x^(i + j), and the sums of x^i times the cash flow. Each block of paths
+ * adds its sums up while its stock prices are in the cache, and the blocks' sums are added in
+ * block order, so the price is the same to the last bit whatever the number of threads.
+ *
+ * The decisions are fitted on the same paths they are applied to, which biases the price up
+ * by a little of the standard error at the path counts used here.
+ */
+template<class Payoff>
+class LongstaffSchwartzEngine {
+public:
+    // paths simulated and regressed together
+    static constexpr std::size_t blockPaths = 1024;
+    // highest degree of the regression polynomial
+    static constexpr int maxDegree = 5;
+
+private:
+    double stockPrice;
+    double volatility;
+    double strikePrice;
+    double time;
+    double intRate;
+    int steps;
+    int simulations;
+    int degree;
+
+    /**
+     * Normal equations of one block: powers[k] = sum x^k for k up to twice the degree and
+     * moments[i] = sum x^i y, over the paths in the money.
+     */
+    struct Sums {
+        double powers[2 * maxDegree + 1] = {};
+        double moments[maxDegree + 1] = {};
+    };
+
+    /**
+     * Solves the normal equations by Cholesky factorization.
+     *
+     * @return Whether the matrix was positive definite, false when too few paths were in the
+     * money to fit the polynomial.
+     */
+    bool solve(const Sums& sums, double* coefficients) const {
+        const int size = degree + 1;
+        double factor[maxDegree + 1][maxDegree + 1];
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j <= i; j++) {
+                double sum = sums.powers[i + j];
+                for (int k = 0; k < j; k++) {
+                    sum -= factor[i][k] * factor[j][k];
+                }
+                if (i == j) {
+                    if (!(sum > 1e-12 * sums.powers[2 * i])) {
+                        return false;
+                    }
+                    factor[i][i] = std::sqrt(sum);
+                } else {
+                    factor[i][j] = sum / factor[j][j];
+                }
+            }
+        }
+        double forward[maxDegree + 1];
+        for (int i = 0; i < size; i++) {
+            double sum = sums.moments[i];
+            for (int k = 0; k < i; k++) {
+                sum -= factor[i][k] * forward[k];
+            }
+            forward[i] = sum / factor[i][i];
+        }
+        for (int i = size - 1; i >= 0; i--) {
+            double sum = forward[i];
+            for (int k = i + 1; k < size; k++) {
+                sum -= factor[k][i] * coefficients[k];
+            }
+            coefficients[i] = sum / factor[i][i];
+        }
+        return true;
+    }
+
+public:
+    /**
+     * @param steps Number of time steps, the option can be exercised at the end of each.
+     * @param simulations Number of paths.
+     * @param degree Degree of the regression polynomial, 1 to maxDegree.
+     * @throws std::invalid_argument If there are fewer than 1 steps or 2 simulations.
+     */
+    LongstaffSchwartzEngine(double stockPrice, double volatility, double strikePrice, double time,
+                            double intRate, int steps, int simulations, int degree = 3)
+            : stockPrice(stockPrice), volatility(volatility), strikePrice(strikePrice),
+              time(time), intRate(intRate), steps(steps), simulations(simulations),
+              degree(std::min(std::max(degree, 1), maxDegree)) {
+        if (steps < 1 || simulations < 2) {
+            throw std::invalid_argument("Least squares Monte Carlo needs an exercise date and "
+                                        "two simulations");
+        }
+    }
+
+    /**
+     * Estimates the price with its standard error, from the Philox streams of the paths.
+     *
+     * @param seed Seed of the Philox generator.
+     * @param pool Threads to simulate and regress the blocks on, nullptr for the calling
+     * thread only.
+     * @return The estimated price with its statistics, effectiveSpeedup being 1.
+     */
+    MonteCarloEstimate estimate(std::uint64_t seed, ThreadPool* pool = nullptr) const {
+        const std::size_t paths = simulations;
+        const std::size_t blocks = (paths + blockPaths - 1) / blockPaths;
+        const Philox philox(seed);
+        const double step = time / steps;
+        const double drift = (intRate - 0.5 * volatility * volatility) * step;
+        const double diffusion = volatility * std::sqrt(step);
+        const double stepDiscount = std::exp(-intRate * step);
+        const double inverseStrike = 1 / strikePrice;
+        auto forBlocks = [&](auto body) {
+            auto run = [&](std::size_t begin, std::size_t end) {
+                for (std::size_t block = begin; block < end; block++) {
+                    std::size_t first = block * blockPaths;
+                    body(block, first, std::min(blockPaths, paths - first));
+                }
+            };
+            if (pool) {
+                pool->parallelFor(blocks, 1, run);
+            } else {
+                run(0, blocks);
+            }
+        };
+
+        // stock prices of the exercise dates before expiration, date k's starting at k * paths,
+        // and the cash flow of each path, at expiration to begin with
+        std::vector<float> stockPrices(static_cast<std::size_t>(steps - 1) * paths);
+        std::vector<double> cashFlows(paths);
+        forBlocks([&](std::size_t, std::size_t first, std::size_t count) {
+            std::vector<double> prices(count, stockPrice), normals(count);
+            for (int k = 0; k < steps; k++) {
+                philox.normals(first, count, k, normals.data());
+                stepPaths(prices.data(), normals.data(), count, drift, diffusion);
+                if (k + 1 < steps) {
+                    std::copy(prices.begin(), prices.end(),
+                              stockPrices.begin() + static_cast<std::size_t>(k) * paths + first);
+                }
+            }
+            for (std::size_t i = 0; i < count; i++) {
+                cashFlows[first + i] = Payoff::payout(prices[i], strikePrice);
+            }
+        });
+
+        std::vector<Sums> blockSums(blocks);
+        for (int k = steps - 2; k >= 0; k--) {
+            const float* datePrices = stockPrices.data() + static_cast<std::size_t>(k) * paths;
+            forBlocks([&](std::size_t block, std::size_t first, std::size_t count) {
+                Sums sums;
+                for (std::size_t i = first; i < first + count; i++) {
+                    double cashFlow = cashFlows[i] * stepDiscount;
+                    cashFlows[i] = cashFlow;
+                    double price = datePrices[i];
+                    if (Payoff::payout(price, strikePrice) > 0) {
+                        double x = price * inverseStrike, power = 1;
+                        for (int j = 0; j <= 2 * degree; j++) {
+                            sums.powers[j] += power;
+                            if (j <= degree) {
+                                sums.moments[j] += power * cashFlow;
+                            }
+                            power *= x;
+                        }
+                    }
+                }
+                blockSums[block] = sums;
+            });
+            Sums sums;
+            for (const Sums& block : blockSums) {
+                for (int j = 0; j <= 2 * degree; j++) {
+                    sums.powers[j] += block.powers[j];
+                }
+                for (int j = 0; j <= degree; j++) {
+                    sums.moments[j] += block.moments[j];
+                }
+            }
+            double coefficients[maxDegree + 1];
+            if (!solve(sums, coefficients)) {
+                continue;
+            }
+            forBlocks([&](std::size_t, std::size_t first, std::size_t count) {
+                for (std::size_t i = first; i < first + count; i++) {
+                    double price = datePrices[i];
+                    double exercise = Payoff::payout(price, strikePrice);
+                    double x = price * inverseStrike, continuation = coefficients[degree];
+                    for (int j = degree - 1; j >= 0; j--) {
+                        continuation = continuation * x + coefficients[j];
+                    }
+                    cashFlows[i] = exercise > 0 && exercise > continuation ? exercise
+                                                                          : cashFlows[i];
+                }
+            });
+        }
+
+        double sum = 0, square = 0;
+        for (double cashFlow : cashFlows) {
+            sum += cashFlow * stepDiscount;
+            square += cashFlow * cashFlow * stepDiscount * stepDiscount;
+        }
+        const double n = static_cast<double>(paths);
+        MonteCarloEstimate result;
+        result.price = std::max(sum / n, Payoff::payout(stockPrice, strikePrice));
+        result.standardError = std::sqrt(std::max(square - sum * sum / n, 0.0) / (n - 1) / n);
+        result.paths = paths;
+        result.effectiveSpeedup = 1;
+        return result;
+    }
+};
+
+#endif //OPTIONSTRACKER_LONGSTAFFSCHWARTZENGINE_H
@@ -1,6 +1,7 @@
-#include <random>
-#include <boost/math/distributions/normal.hpp>
+#include <chrono>
 #include "MonteCarlo.h"
+#include "LongstaffSchwartzEngine.h"
+#include "PricingEngines.h"
 
 /**
  * Constructor for the MonteCarlo class. This method initializes the properties of the class.
@@ -15,7 +16,21 @@
 MonteCarlo::MonteCarlo(double stockPrice, double volatility, double strikePrice, double time,
                        double intRate, int simulations) :
         Option(stockPrice, volatility, strikePrice, time, intRate), simulations
-        (simulations) {
+        (simulations), seed(std::chrono::system_clock::now().time_since_epoch().count()),
+        pool(nullptr) {
+
+}
+
+/**
+ * Constructor for a reproducible simulation.
+ *
+ * @param seed Seed of the Philox generator the paths are drawn from.
+ * @param pool Threads to split the paths between, nullptr for the calling thread only.
+ */
+MonteCarlo::MonteCarlo(double stockPrice, double volatility, double strikePrice, double time,
+                       double intRate, int simulations, std::uint64_t seed, ThreadPool* pool) :
+        Option(stockPrice, volatility, strikePrice, time, intRate), simulations(simulations),
+        seed(seed), pool(pool) {
 
 }
 
@@ -25,24 +40,8 @@ MonteCarlo::MonteCarlo(double stockPrice, double volatility, double strikePrice,
  * @return The calculated price of the put option.
  */
 double MonteCarlo::putOptionPrice() {
-    double sumPayoffs =0;
-    std::default_random_engine nums(std::chrono::system_clock::now().time_since_epoch().count());
-    std::normal_distribution<double> norm(0.0, 1.0);
-
-    // Loop over the number of simulations
-    for(size_t i =0;i<simulations;i++){
-        // Simulate a stock price path
-        double simPrice = stockPrice * std::exp((intRate - 0.5 * pow(volatility,2)) *time
-                                                + volatility * sqrt(time) * norm(nums));
-        // Compute the payoff of the put option
-        double payoff = std::max(strikePrice - simPrice,0.0);
-        sumPayoffs += payoff;
-
-    }
-
-    // Calculate the price of the put option
-    double price = sumPayoffs/simulations * std::exp(-intRate*time);
-    return price;
+    return MonteCarloEngine<PutPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                       simulations).estimate(seed, reduction, pool).price;
 }
 
 /**
@@ -51,22 +50,61 @@ double MonteCarlo::putOptionPrice() {
  * @return The calculated price of the call option.
  */
 double MonteCarlo::callOptionPrice() {
-    double sumPayoffs =0;
-    std::default_random_engine nums(std::chrono::system_clock::now().time_since_epoch().count());
-    std::normal_distribution<double> norm(0.0, 1.0);
+    return MonteCarloEngine<CallPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                        simulations).estimate(seed, reduction, pool).price;
+}
 
-    // Loop over the number of simulations
-    for(size_t i =0;i<simulations;i++){
-        // Simulate a stock price path
-        double simPrice = stockPrice * std::exp((intRate - 0.5 * pow(volatility,2)) *time
-                                                + volatility * sqrt(time) * norm(nums));
-        // Compute the payoff of the call option
-        double payoff = std::max(simPrice - strikePrice,0.0);
-        sumPayoffs += payoff;
+/**
+ * This method computes the prices of the call and the put from the same simulated paths.
+ *
+ * @return The calculated prices of the call and the put.
+ */
+CallPut MonteCarlo::callPutPrice() {
+    CallPutEstimate estimate = stripEstimate({strikePrice})[0];
+    return {estimate.call.price, estimate.put.price};
+}
+
+/**
+ * Prices the call or the put with the chosen variance reduction.
+ *
+ * @param type Whether to price the call or the put.
+ * @return The estimated price with its statistics.
+ */
+MonteCarloEstimate MonteCarlo::estimate(OptionType type) {
+    if (type == OptionType::Call) {
+        return MonteCarloEngine<CallPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                            simulations).estimate(seed, reduction, pool);
+    }
+    return MonteCarloEngine<PutPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                       simulations).estimate(seed, reduction, pool);
+}
 
+/**
+ * Prices the call or the put with early exercise on equally spaced dates.
+ *
+ * @param type Whether to price the call or the put.
+ * @param exerciseDates Number of exercise dates, the last at expiration.
+ * @param degree Degree of the regression polynomial.
+ * @return The estimated price with its statistics.
+ */
+MonteCarloEstimate MonteCarlo::americanEstimate(OptionType type, int exerciseDates, int degree) {
+    if (type == OptionType::Call) {
+        return LongstaffSchwartzEngine<CallPayoff>(stockPrice, volatility, strikePrice, time,
+                                                   intRate, exerciseDates, simulations, degree)
+                .estimate(seed, pool);
     }
+    return LongstaffSchwartzEngine<PutPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                              exerciseDates, simulations, degree)
+            .estimate(seed, pool);
+}
 
-    // Calculate the price of the call option
-    double price = sumPayoffs/simulations * std::exp(-intRate*time);
-    return price;
+/**
+ * Prices the calls and puts of several strikes in one pass.
+ *
+ * @param strikePrices Strike prices to price.
+ * @return The call and the put of each strike with their statistics.
+ */
+std::vector<CallPutEstimate> MonteCarlo::stripEstimate(const std::vector<double>& strikePrices) {
+    return MonteCarloStripEngine(stockPrice, volatility, time, intRate, simulations)
+            .estimate(strikePrices, seed, reduction, pool);
 }
@@ -3,17 +3,26 @@
 #define OPTIONSTRACKER_MONTECARLO_H
 
 
+#include <cstdint>
+#include <vector>
 #include "Option.h"
+#include "PricingEngines.h"
+
 /**
  * This class simulates the option price using the montecarlo method
  * It will estimate the price using random values and as such will change each run
  * the more simulations the better but the longer the program will take
- *
+ * The simulation itself is MonteCarloEngine of PricingEngines.h, this class adapts it to the
+ * Option interface. The paths are drawn from Philox streams: given a seed the estimate is the
+ * same on every run and for any number of threads, without one it is seeded from the clock.
  */
 class MonteCarlo : public Option{
 private:
     //number of simulations
     int simulations;
+    std::uint64_t seed = 0;
+    ThreadPool* pool = nullptr;
+    VarianceReduction reduction = VarianceReduction::None;
 
 
 public:
@@ -25,11 +34,67 @@ public:
     //uses the options constructor and then initializes the simulations
     MonteCarlo(double stockPrice, double volatility, double strikePrice, double time,
                double intRate, int simulations);
+
+    /**
+     * Reproducible simulation: the same seed gives the same prices whatever the pool.
+     *
+     * @param seed Seed of the Philox generator.
+     * @param pool Threads to split the paths between, nullptr for the calling thread only.
+     */
+    MonteCarlo(double stockPrice, double volatility, double strikePrice, double time,
+               double intRate, int simulations, std::uint64_t seed, ThreadPool* pool = nullptr);
+
     //overrrides the callOptionPrice from the options base class
     double callOptionPrice() override;
 
     //overrrides the putOptionPrice from the options base class
     double putOptionPrice() override;
+
+    /**
+     * Prices the call and the put from one simulation with MonteCarloStripEngine, half the
+     * work of pricing them apart, and with their difference free of simulation noise.
+     */
+    CallPut callPutPrice() override;
+
+    /**
+     * Chooses the variance reduction of the following prices and estimates, None by default.
+     */
+    void setVarianceReduction(VarianceReduction varianceReduction) {
+        reduction = varianceReduction;
+    }
+
+    /**
+     * Prices one side of the option with its standard error and the speedup the variance
+     * reduction achieved over crude Monte Carlo, to choose the number of paths for a target
+     * confidence interval.
+     *
+     * @param type Whether to price the call or the put.
+     * @return The estimated price with its statistics.
+     */
+    MonteCarloEstimate estimate(OptionType type);
+
+    /**
+     * Prices one side of the option with early exercise by the least squares Monte Carlo of
+     * LongstaffSchwartzEngine, exercisable on equally spaced dates, which approaches the
+     * American option as the dates get closer. Uses the simulations, seed and pool of the
+     * European prices; the variance reduction does not apply.
+     *
+     * @param type Whether to price the call or the put.
+     * @param exerciseDates Number of exercise dates, the last at expiration.
+     * @param degree Degree of the regression polynomial, 1 to 5.
+     * @return The estimated price with its statistics.
+     * @throws std::invalid_argument If there are fewer than 1 exercise dates or 2 simulations.
+     */
+    MonteCarloEstimate americanEstimate(OptionType type, int exerciseDates, int degree = 3);
+
+    /**
+     * Prices the calls and puts of several strikes from the same paths in a single pass, with
+     * the chosen variance reduction. The option's own strike is not used.
+     *
+     * @param strikePrices Strike prices to price.
+     * @return The call and the put of each strike with their statistics.
+     */
+    std::vector<CallPutEstimate> stripEstimate(const std::vector<double>& strikePrices);
 };
 
 
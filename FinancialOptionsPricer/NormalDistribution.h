@@ -0,0 +1,186 @@
+#ifndef OPTIONSTRACKER_NORMALDISTRIBUTION_H
+#define OPTIONSTRACKER_NORMALDISTRIBUTION_H
+#include <cstddef>
+#include "SimdMath.h"
+
+/**
+ * How accurately the pricers evaluate the standard normal distribution. Full is accurate to
+ * the last bit of a double, High to about 1e-12 and Fast to about 1e-7, each cheaper than the
+ * one before. End of day marks should stay at Full, screening many options can use Fast.
+ */
+enum class NormalAccuracy {
+    Full,
+    High,
+    Fast
+};
+
+/**
+ * Standard normal distribution functions of one accuracy tier. The pricing engines are
+ * templates over these policies, so each tier compiles to straight line code with nothing to
+ * decide per evaluation. Every policy has a cdf and a pdf for a double and for the register
+ * wrappers of SimdVec.h, the double versions being defined in NormalDistribution.cpp.
+ */
+
+/**
+ * Full double precision. The double cdf is 0.5 * erfc(-x / sqrt(2)) from the standard
+ * library, accurate relative to even the tiniest tail probabilities. The register version is
+ * simdNormalCdf, whose absolute error is below 3e-16.
+ */
+struct NormalFull {
+    static double cdf(double x);
+    static double pdf(double x);
+
+    template<class V>
+    static V cdf(V x) {
+        return simdNormalCdf(x);
+    }
+
+    template<class V>
+    static V pdf(V x) {
+        return V::broadcast(0.3989422804014327) * simdExp(V::broadcast(-0.5) * x * x);
+    }
+};
+
+/**
+ * Absolute error below 1e-12. Hart's rational function from simdNormalCdf without the
+ * continued fraction for the far tail, where the probability is below 8e-13 and taken as 0,
+ * and e^x from a degree 10 Taylor polynomial.
+ */
+struct NormalHigh {
+    static double cdf(double x);
+    static double pdf(double x);
+
+    template<class V>
+    static V cdf(V x) {
+        const V z = abs(x);
+        V numerator = V::broadcast(3.52624965998911e-2);
+        numerator = fmadd(numerator, z, V::broadcast(0.700383064443688));
+        numerator = fmadd(numerator, z, V::broadcast(6.37396220353165));
+        numerator = fmadd(numerator, z, V::broadcast(33.912866078383));
+        numerator = fmadd(numerator, z, V::broadcast(112.079291497871));
+        numerator = fmadd(numerator, z, V::broadcast(221.213596169931));
+        numerator = fmadd(numerator, z, V::broadcast(220.206867912376));
+        V denominator = V::broadcast(8.83883476483184e-2);
+        denominator = fmadd(denominator, z, V::broadcast(1.75566716318264));
+        denominator = fmadd(denominator, z, V::broadcast(16.064177579207));
+        denominator = fmadd(denominator, z, V::broadcast(86.7807322029461));
+        denominator = fmadd(denominator, z, V::broadcast(296.564248779674));
+        denominator = fmadd(denominator, z, V::broadcast(637.333633378831));
+        denominator = fmadd(denominator, z, V::broadcast(793.826512519948));
+        denominator = fmadd(denominator, z, V::broadcast(440.413735824752));
+        V lower = simdExpTaylor<10>(V::broadcast(-0.5) * z * z) * numerator / denominator;
+        lower = select(lessThan(z, V::broadcast(7.07106781186547)), lower, V::broadcast(0.0));
+        return select(lessThan(V::broadcast(0.0), x), V::broadcast(1.0) - lower, lower);
+    }
+
+    template<class V>
+    static V pdf(V x) {
+        return V::broadcast(0.3989422804014327) * simdExpTaylor<10>(V::broadcast(-0.5) * x * x);
+    }
+};
+
+/**
+ * Absolute error below 1e-7. The polynomial of Abramowitz and Stegun 26.2.17 in
+ * t = 1 / (1 + 0.2316419 |x|) times the pdf, whose e^x comes from a degree 7 Taylor polynomial.
+ */
+struct NormalFast {
+    static double cdf(double x);
+    static double pdf(double x);
+
+    template<class V>
+    static V cdf(V x) {
+        const V z = abs(x);
+        const V t = V::broadcast(1.0) / fmadd(V::broadcast(0.2316419), z, V::broadcast(1.0));
+        V p = V::broadcast(1.330274429);
+        p = fmadd(p, t, V::broadcast(-1.821255978));
+        p = fmadd(p, t, V::broadcast(1.781477937));
+        p = fmadd(p, t, V::broadcast(-0.356563782));
+        p = fmadd(p, t, V::broadcast(0.319381530));
+        V lower = pdf(z) * p * t;
+        return select(lessThan(V::broadcast(0.0), x), V::broadcast(1.0) - lower, lower);
+    }
+
+    template<class V>
+    static V pdf(V x) {
+        return V::broadcast(0.3989422804014327) * simdExpTaylor<7>(V::broadcast(-0.5) * x * x);
+    }
+};
+
+/**
+ * Standard normal cumulative distribution function of the given accuracy tier, for callers
+ * that choose the tier at runtime.
+ */
+double normalCdf(double x, NormalAccuracy accuracy = NormalAccuracy::Full);
+
+/**
+ * Standard normal density of the given accuracy tier, for callers that choose the tier at
+ * runtime.
+ */
+double normalPdf(double x, NormalAccuracy accuracy = NormalAccuracy::Full);
+
+/**
+ * Inverse of the standard normal distribution function, accurate to a few units in the last
+ * place: Acklam's approximation simdNormalQuantile, good to 1.2e-9, refined by one Halley step
+ * against the Full cdf. Quasi-Monte Carlo needs the refinement, its errors fall far enough for
+ * the approximation's to show.
+ *
+ * @param p Probability, strictly between 0 and 1.
+ * @return The x with N(x) = p.
+ */
+double normalQuantile(double p);
+
+/**
+ * Standard normal cumulative distribution function of the given accuracy tier at many points,
+ * with the vectorized kernel of the active SimdLevel. Counts too small to fill an AVX-512
+ * register still use AVX2 registers, so even the four values of a call and a put are computed
+ * together.
+ *
+ * @param points Points to evaluate the function at.
+ * @param cdf Receives the value at each point.
+ * @param count Number of points.
+ * @param accuracy Accuracy tier, Full uses simdNormalCdf for whole registers.
+ */
+void normalCdf(const double* points, double* cdf, std::size_t count,
+               NormalAccuracy accuracy = NormalAccuracy::Full);
+
+// Kernels of each instruction set, picked between by normalCdf.
+namespace scalar {
+    void normalCdf(const double* points, double* cdf, std::size_t count, NormalAccuracy accuracy);
+}
+namespace avx2 {
+    void normalCdf(const double* points, double* cdf, std::size_t count, NormalAccuracy accuracy);
+}
+namespace avx512 {
+    void normalCdf(const double* points, double* cdf, std::size_t count, NormalAccuracy accuracy);
+}
+
+/**
+ * Kernel body, instantiated with the register wrappers of SimdVec.h and a normal distribution
+ * policy. Evaluates points [begin, end) a register at a time and returns where it stopped, the
+ * caller finishes the remaining points with a narrower register.
+ */
+template<class V, class Normal>
+std::size_t normalCdfKernel(const double* points, double* cdf, std::size_t begin,
+                            std::size_t end) {
+    std::size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        Normal::cdf(V::load(points + i)).store(cdf + i);
+    }
+    return i;
+}
+
+// The kernel with the policy of the accuracy tier.
+template<class V>
+std::size_t normalCdfKernel(const double* points, double* cdf, std::size_t begin,
+                            std::size_t end, NormalAccuracy accuracy) {
+    switch (accuracy) {
+        case NormalAccuracy::High:
+            return normalCdfKernel<V, NormalHigh>(points, cdf, begin, end);
+        case NormalAccuracy::Fast:
+            return normalCdfKernel<V, NormalFast>(points, cdf, begin, end);
+        default:
+            return normalCdfKernel<V, NormalFull>(points, cdf, begin, end);
+    }
+}
+
+#endif //OPTIONSTRACKER_NORMALDISTRIBUTION_H
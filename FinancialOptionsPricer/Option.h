@@ -1,6 +1,34 @@
 
 #ifndef OPTIONSTRACKER_OPTION_H
 #define OPTIONSTRACKER_OPTION_H
+
+/**
+ * Call and put values computed together for the same option parameters.
+ */
+struct CallPut {
+    double call;
+    double put;
+};
+
+/**
+ * When the holder of an option may exercise it. European options can only be exercised at
+ * expiration, American options at any time before it and Bermudan options on a schedule of
+ * exercise dates.
+ */
+enum class ExerciseStyle {
+    European,
+    American,
+    Bermudan
+};
+
+/**
+ * Whether an option is the right to buy the stock (a call) or to sell it (a put).
+ */
+enum class OptionType : unsigned char {
+    Call,
+    Put
+};
+
 class Option{
     protected:
         double stockPrice;
@@ -22,6 +50,10 @@ class Option{
         virtual double callOptionPrice() = 0; // pure virtual function
         virtual double putOptionPrice() = 0;  // pure virtual function
 
+        // prices both sides of the option, pricers that can share work between the call and the
+        // put override this to compute them in a single pass
+        virtual CallPut callPutPrice() { return {callOptionPrice(), putOptionPrice()}; }
+
 
 };
 
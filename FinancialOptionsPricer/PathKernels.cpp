@@ -0,0 +1,24 @@
+#include "PathKernels.h"
+#include "Simd.h"
+#include "SimdVec.h"
+
+void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+               double diffusion) {
+    switch (activeSimdLevel()) {
+        case SimdLevel::AVX512:
+            avx512::stepPaths(stockPrices, normals, count, drift, diffusion);
+            break;
+        case SimdLevel::AVX2:
+            avx2::stepPaths(stockPrices, normals, count, drift, diffusion);
+            break;
+        default:
+            scalar::stepPaths(stockPrices, normals, count, drift, diffusion);
+    }
+}
+
+namespace scalar {
+    void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+                   double diffusion) {
+        stepPathsKernel<ScalarVec>(stockPrices, normals, 0, count, drift, diffusion);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef OPTIONSTRACKER_PATHKERNELS_H
+#define OPTIONSTRACKER_PATHKERNELS_H
+#include <cstddef>
+#include "SimdMath.h"
+
+/**
+ * Advances a block of simulated stock prices by one time step of geometric Brownian motion,
+ * stockPrices[i] *= e^(drift + diffusion * normals[i]). The paths of a block are stored next to
+ * each other, so one step of all of them is a single streaming loop over the block. This
+ * dispatches to the kernel of the active SimdLevel.
+ *
+ * @param stockPrices Stock price of each path, replaced by its price a step later.
+ * @param normals Standard normal number of each path for the step.
+ * @param count Number of paths.
+ * @param drift (r - vol^2 / 2) times the length of the step.
+ * @param diffusion vol times the square root of the length of the step.
+ */
+void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+               double diffusion);
+
+// Kernels of each instruction set, picked between by stepPaths.
+namespace scalar {
+    void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+                   double diffusion);
+}
+namespace avx2 {
+    void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+                   double diffusion);
+}
+namespace avx512 {
+    void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+                   double diffusion);
+}
+
+/**
+ * Kernel body, instantiated with the register wrappers of SimdVec.h. Steps paths
+ * [begin, end) a register at a time and returns where it stopped, the caller finishes the
+ * remaining paths with a narrower register.
+ */
+template<class V>
+std::size_t stepPathsKernel(double* stockPrices, const double* normals, std::size_t begin,
+                            std::size_t end, double drift, double diffusion) {
+    const V driftV = V::broadcast(drift);
+    const V diffusionV = V::broadcast(diffusion);
+    std::size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        V growth = simdExp(fmadd(diffusionV, V::load(normals + i), driftV));
+        (V::load(stockPrices + i) * growth).store(stockPrices + i);
+    }
+    return i;
+}
+
+#endif //OPTIONSTRACKER_PATHKERNELS_H
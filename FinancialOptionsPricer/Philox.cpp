@@ -0,0 +1,58 @@
+#include "Philox.h"
+#include <algorithm>
+#include "PhiloxKernels.h"
+#include "Simd.h"
+#include "SimdMath.h"
+
+/**
+ * Whole counter groups go to the kernel of the active SimdLevel, which encrypts a register of
+ * counters at a time. A group at either end of the run that is only partly in it is computed
+ * whole into a buffer, of which the paths in the run are copied, so every path's number comes
+ * from the same kernel however the run is split.
+ */
+void Philox::normals(std::uint64_t firstPath, std::size_t count, std::uint32_t draw,
+                     double* normals) const {
+    auto groupNormals = [&](std::uint64_t firstGroup, std::size_t groups, double* out) {
+        switch (activeSimdLevel()) {
+            case SimdLevel::AVX512:
+                avx512::philoxNormals(key[0], key[1], firstGroup, groups, draw, out);
+                break;
+            case SimdLevel::AVX2:
+                avx2::philoxNormals(key[0], key[1], firstGroup, groups, draw, out);
+                break;
+            default:
+                scalar::philoxNormals(key[0], key[1], firstGroup, groups, draw, out);
+        }
+    };
+    const std::uint64_t end = firstPath + count;
+    std::uint64_t path = firstPath;
+    double* out = normals;
+    // paths [path, stop) of path's counter group
+    auto partialGroup = [&](std::uint64_t stop) {
+        double group[4];
+        groupNormals(path >> 2, 1, group);
+        std::copy(group + (path & 3), group + (path & 3) + (stop - path), out);
+        out += stop - path;
+        path = stop;
+    };
+
+    if ((path & 3) != 0 && path < end) {
+        partialGroup(std::min(end, (path | 3) + 1));
+    }
+    const std::size_t groups = (end - path) >> 2;
+    if (groups > 0) {
+        groupNormals(path >> 2, groups, out);
+        out += 4 * groups;
+        path += 4 * groups;
+    }
+    if (path < end) {
+        partialGroup(end);
+    }
+}
+
+namespace scalar {
+    void philoxNormals(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                       std::size_t groups, std::uint32_t draw, double* normals) {
+        philoxNormalsKernel<ScalarVec>(key0, key1, firstGroup, 0, groups, draw, normals);
+    }
+}
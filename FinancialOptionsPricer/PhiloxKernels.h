@@ -0,0 +1,73 @@
+#ifndef OPTIONSTRACKER_PHILOXKERNELS_H
+#define OPTIONSTRACKER_PHILOXKERNELS_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "SimdMath.h"
+
+// Kernels of each instruction set for Philox::normals, filling the paths of whole counter
+// groups: group g's four paths 4 g to 4 g + 3 go to normals[4 (g - firstGroup)] onwards.
+namespace scalar {
+    void philoxNormals(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                       std::size_t groups, std::uint32_t draw, double* normals);
+}
+namespace avx2 {
+    void philoxNormals(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                       std::size_t groups, std::uint32_t draw, double* normals);
+}
+namespace avx512 {
+    void philoxNormals(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                       std::size_t groups, std::uint32_t draw, double* normals);
+}
+
+/**
+ * Kernel body, instantiated with the register wrappers of SimdVec.h. Each lane runs the ten
+ * rounds of Philox4x32-10 on the counter of one group, so a register encrypts width counters
+ * at once with the 32 x 32 to 64 bit multiplications of its Words. The four words of each
+ * counter become uniforms and normal numbers a register at a time and are then interleaved
+ * into path order. Works through groups [begin, end) and returns end: a last register only
+ * partly inside the range still encrypts width counters, into a buffer of which the groups in
+ * range are copied. Every group thus goes through the same register width, and since each lane
+ * only depends on its own counter, a group's numbers are the same wherever it falls in a run.
+ */
+template<class V>
+std::size_t philoxNormalsKernel(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                                std::size_t begin, std::size_t end, std::uint32_t draw,
+                                double* normals) {
+    typedef typename V::Words W;
+    const W multiplier0 = W::broadcast(0xD2511F53), multiplier1 = W::broadcast(0xCD9E8D57);
+    std::size_t g = begin;
+    alignas(64) double partial[4 * V::width];
+    for (; g < end; g += V::width) {
+        const W group = W::iota(firstGroup + g);
+        W counter[4] = {W::broadcast(draw), W::broadcast(0), low32(group), high32(group)};
+        std::uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < 10; round++) {
+            W product0 = mulWide(multiplier0, counter[0]);
+            W product1 = mulWide(multiplier1, counter[2]);
+            counter[0] = high32(product1) ^ counter[1] ^ W::broadcast(k0);
+            counter[1] = low32(product1);
+            counter[2] = high32(product0) ^ counter[3] ^ W::broadcast(k1);
+            counter[3] = low32(product0);
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        alignas(64) double words[4][V::width];
+        for (int w = 0; w < 4; w++) {
+            simdNormalQuantile(uniformOf(counter[w])).store(words[w]);
+        }
+        const bool whole = g + V::width <= end;
+        double* out = whole ? normals + 4 * g : partial;
+        for (int lane = 0; lane < V::width; lane++) {
+            for (int w = 0; w < 4; w++) {
+                out[4 * lane + w] = words[w][lane];
+            }
+        }
+        if (!whole) {
+            std::copy(partial, partial + 4 * (end - g), normals + 4 * g);
+        }
+    }
+    return end;
+}
+
+#endif //OPTIONSTRACKER_PHILOXKERNELS_H
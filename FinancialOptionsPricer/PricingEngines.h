@@ -0,0 +1,554 @@
+#ifndef OPTIONSTRACKER_PRICINGENGINES_H
+#define OPTIONSTRACKER_PRICINGENGINES_H
+
+/**
+ * Pricing engines as templates over the payoff, the exercise style and the floating point type.
+ * The classes deriving from Option pick the payoff with a virtual call and a run time sign, which
+ * the compiler can't see through; here each combination is its own instantiation, so the payoff
+ * and the early exercise test are inlined into the inner loops and the loops can be vectorized
+ * for float as well as double. Option keeps its virtual interface as an adapter over these for
+ * callers that choose the pricer at run time.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "LatticeKernels.h"
+#include "Option.h"
+#include "PathKernels.h"
+#include "Philox.h"
+#include "ThreadPool.h"
+
+/**
+ * Payoff of a call, max(S - K, 0).
+ */
+struct CallPayoff {
+    static constexpr OptionType type = OptionType::Call;
+    // 1 for a call, -1 for a put, as in the sign * (S - K) form of the payoffs
+    static constexpr int sign = 1;
+
+    template<class Real>
+    static Real payout(Real stockPrice, Real strikePrice) {
+        return std::max(stockPrice - strikePrice, Real(0));
+    }
+};
+
+/**
+ * Payoff of a put, max(K - S, 0).
+ */
+struct PutPayoff {
+    static constexpr OptionType type = OptionType::Put;
+    static constexpr int sign = -1;
+
+    template<class Real>
+    static Real payout(Real stockPrice, Real strikePrice) {
+        return std::max(strikePrice - stockPrice, Real(0));
+    }
+};
+
+/**
+ * Exercise at expiration only.
+ */
+struct EuropeanExercise {
+    static constexpr ExerciseStyle style = ExerciseStyle::European;
+    static constexpr bool early = false;
+};
+
+/**
+ * Exercise at any time up to expiration.
+ */
+struct AmericanExercise {
+    static constexpr ExerciseStyle style = ExerciseStyle::American;
+    static constexpr bool early = true;
+};
+
+/**
+ * Black-Scholes formula for a European option, sign * (S N(sign d1) - K e^(-rT) N(sign d2)),
+ * with the normal distribution evaluated through std::erfc in the engine's type.
+ */
+template<class Payoff, class Real = double>
+class BlackScholesEngine {
+private:
+    Real stockPrice;
+    Real volatility;
+    Real strikePrice;
+    Real time;
+    Real intRate;
+
+    static Real normalCdf(Real x) {
+        return Real(0.5) * std::erfc(-x * Real(0.7071067811865476));
+    }
+
+public:
+    BlackScholesEngine(Real stockPrice, Real volatility, Real strikePrice, Real time, Real intRate)
+            : stockPrice(stockPrice), volatility(volatility), strikePrice(strikePrice), time(time),
+              intRate(intRate) { }
+
+    /**
+     * @return The price of the option.
+     */
+    Real price() const {
+        const Real sign = Payoff::sign;
+        Real deviation = volatility * std::sqrt(time);
+        Real d1 = (std::log(stockPrice / strikePrice) +
+                   time * (intRate + Real(0.5) * volatility * volatility)) / deviation;
+        Real d2 = d1 - deviation;
+        Real discountedStrike = strikePrice * std::exp(-intRate * time);
+        return sign * (stockPrice * normalCdf(sign * d1) - discountedStrike * normalCdf(sign * d2));
+    }
+};
+
+/**
+ * Variance reduction of a Monte Carlo estimate.
+ */
+enum class VarianceReduction {
+    // crude Monte Carlo, one path per normal number
+    None,
+    // each normal number Z drives two paths, with Z and -Z, and their payoffs are averaged
+    Antithetic,
+    // the stock price at expiration, whose mean is the forward S e^(rT), as a control variate
+    ControlVariate,
+    // antithetic pairs with the pair's average stock price as the control variate
+    AntitheticControlVariate
+};
+
+/**
+ * A Monte Carlo price with the statistics to judge it.
+ */
+struct MonteCarloEstimate {
+    double price;
+    // standard deviation of the price as an estimate, from the spread of the paths
+    double standardError;
+    // number of paths simulated, two per normal number with antithetic variates
+    std::size_t paths;
+    // how many times as many paths crude Monte Carlo would need for the same standard error:
+    // the variance of one path's discounted payoff over paths * standardError^2
+    double effectiveSpeedup;
+};
+
+/**
+ * Sums over the samples of a block of Monte Carlo paths, a sample being one path or one
+ * antithetic pair: y its payoff, x its stock price at expiration and p the payoff of each path
+ * on its own. Blocks' sums are added in block order, so the estimate doesn't depend on how the
+ * blocks were split between threads.
+ */
+struct MonteCarloSums {
+    double samples = 0, y = 0, yy = 0, x = 0, xx = 0, xy = 0;
+    double paths = 0, p = 0, pp = 0;
+
+private:
+    void addPayoff(double payoff) {
+        p += payoff;
+        pp += payoff * payoff;
+    }
+
+    void addSample(double sampleY, double sampleX) {
+        samples += 1;
+        y += sampleY;
+        yy += sampleY * sampleY;
+        x += sampleX;
+        xx += sampleX * sampleX;
+        xy += sampleX * sampleY;
+    }
+
+public:
+    void add(const MonteCarloSums& other) {
+        samples += other.samples;
+        y += other.y;
+        yy += other.yy;
+        x += other.x;
+        xx += other.xx;
+        xy += other.xy;
+        paths += other.paths;
+        p += other.p;
+        pp += other.pp;
+    }
+
+    /**
+     * Adds the sample of one path, its payoff and stock price at expiration.
+     */
+    void addPath(double payoff, double stockPrice) {
+        addPayoff(payoff);
+        addSample(payoff, stockPrice);
+        paths += 1;
+    }
+
+    /**
+     * Adds the sample of an antithetic pair of paths, the averages of their payoffs and of their
+     * stock prices at expiration.
+     */
+    void addPair(double payoff, double stockPrice, double mirrorPayoff, double mirrorPrice) {
+        addPayoff(payoff);
+        addPayoff(mirrorPayoff);
+        addSample(0.5 * (payoff + mirrorPayoff), 0.5 * (stockPrice + mirrorPrice));
+        paths += 2;
+    }
+
+    /**
+     * The estimate of the sums of all the samples. With the control variate it is
+     * mean(y) - beta (mean(x) - F), beta the least squares slope of y on x, and its error the
+     * spread of the residuals.
+     *
+     * @param control Whether to use the stock price at expiration as a control variate.
+     * @param forward Mean of the stock price at expiration, S e^(rT).
+     * @param discount Discount factor from expiration, e^(-rT).
+     */
+    MonteCarloEstimate estimate(bool control, double forward, double discount) const {
+        const double n = samples;
+        const double meanY = y / n;
+        const double spreadY = yy - y * meanY;
+        double mean = meanY;
+        double variance = spreadY / (n - 1);
+        if (control) {
+            const double meanX = x / n;
+            const double spreadX = xx - x * meanX;
+            const double spreadXY = xy - x * meanY;
+            const double beta = spreadX > 0 ? spreadXY / spreadX : 0;
+            mean = meanY - beta * (meanX - forward);
+            variance = std::max(spreadY - beta * spreadXY, 0.0) / (n - 2);
+        }
+
+        MonteCarloEstimate result;
+        result.price = mean * discount;
+        result.standardError = std::sqrt(variance / n) * discount;
+        result.paths = static_cast<std::size_t>(paths);
+        const double pathVariance = (pp - p * p / paths) / (paths - 1) * discount * discount;
+        result.effectiveSpeedup = result.standardError > 0
+                ? pathVariance / (paths * result.standardError * result.standardError)
+                : 0;
+        return result;
+    }
+};
+
+/**
+ * Monte Carlo estimate of a European option from simulated stock prices at expiration,
+ * S e^((r - vol^2 / 2) T + vol sqrt(T) Z). The drift, the diffusion and the discount are worked
+ * out once rather than per path.
+ */
+template<class Payoff, class Real = double>
+class MonteCarloEngine {
+private:
+    Real stockPrice;
+    Real volatility;
+    Real strikePrice;
+    Real time;
+    Real intRate;
+    int simulations;
+
+    typedef MonteCarloSums Sums;
+
+    /**
+     * Simulates the samples of one block from their normal numbers.
+     */
+    template<bool antithetic>
+    Sums simulateBlock(const double* normals, std::size_t count, Real drift,
+                       Real diffusion) const {
+        Sums sums;
+        for (std::size_t i = 0; i < count; i++) {
+            Real shock = diffusion * static_cast<Real>(normals[i]);
+            Real simPrice = stockPrice * std::exp(drift + shock);
+            double payoff = Payoff::payout(simPrice, strikePrice);
+            if constexpr (antithetic) {
+                Real mirrorPrice = stockPrice * std::exp(drift - shock);
+                sums.addPair(payoff, simPrice, Payoff::payout(mirrorPrice, strikePrice),
+                             mirrorPrice);
+            } else {
+                sums.addPath(payoff, simPrice);
+            }
+        }
+        return sums;
+    }
+
+public:
+    MonteCarloEngine(Real stockPrice, Real volatility, Real strikePrice, Real time, Real intRate,
+                     int simulations)
+            : stockPrice(stockPrice), volatility(volatility), strikePrice(strikePrice), time(time),
+              intRate(intRate), simulations(simulations) { }
+
+    /**
+     * Estimates the price. The payoffs are summed in double whatever the engine's type, since a
+     * float sum of a million payoffs would lose about as much as the estimate's standard error.
+     *
+     * @param generator Random number engine of the standard library to draw the paths from.
+     * @return The estimated price of the option.
+     */
+    template<class Generator>
+    Real price(Generator& generator) const {
+        std::normal_distribution<Real> normal(0, 1);
+        const Real drift = (intRate - Real(0.5) * volatility * volatility) * time;
+        const Real diffusion = volatility * std::sqrt(time);
+
+        double sumPayoffs = 0;
+        for (int i = 0; i < simulations; i++) {
+            Real simPrice = stockPrice * std::exp(drift + diffusion * normal(generator));
+            sumPayoffs += Payoff::payout(simPrice, strikePrice);
+        }
+        return static_cast<Real>(sumPayoffs / simulations) * std::exp(-intRate * time);
+    }
+
+    /**
+     * Estimates the price from the Philox stream of each path, optionally on several threads,
+     * with a choice of variance reduction. The samples are cut into blocks of a fixed size,
+     * each block's sums are taken in sample order and the block sums are added in block order,
+     * so the result is the same to the last bit for a given seed whatever the number of threads
+     * and however the blocks are scheduled between them.
+     *
+     * Antithetic variates simulate half as many normal numbers, each for two paths. The control
+     * variate estimate is mean(y) - beta (mean(x) - F) with beta the least squares slope of the
+     * payoffs y on the stock prices x, estimated from the same paths; its error is the spread
+     * of the residuals. The Black-Scholes price is the exact answer here rather than a control,
+     * so the stock price is the one control a European payoff can use.
+     *
+     * @param seed Seed of the Philox generator.
+     * @param reduction Variance reduction to apply.
+     * @param pool Threads to simulate the blocks on, nullptr for the calling thread only.
+     * @return The estimated price with its standard error.
+     */
+    MonteCarloEstimate estimate(std::uint64_t seed,
+                                VarianceReduction reduction = VarianceReduction::None,
+                                ThreadPool* pool = nullptr) const {
+        const bool antithetic = reduction == VarianceReduction::Antithetic ||
+                                reduction == VarianceReduction::AntitheticControlVariate;
+        const bool control = reduction == VarianceReduction::ControlVariate ||
+                             reduction == VarianceReduction::AntitheticControlVariate;
+        const std::size_t samples = antithetic ? (simulations + 1) / 2 : simulations;
+        const std::size_t blockSamples = 4096;
+        const std::size_t blocks = (samples + blockSamples - 1) / blockSamples;
+        const Philox philox(seed);
+        const Real drift = (intRate - Real(0.5) * volatility * volatility) * time;
+        const Real diffusion = volatility * std::sqrt(time);
+
+        std::vector<Sums> blockSums(blocks);
+        auto simulateBlocks = [&](std::size_t begin, std::size_t end) {
+            std::vector<double> normals(blockSamples);
+            for (std::size_t block = begin; block < end; block++) {
+                std::size_t first = block * blockSamples;
+                std::size_t count = std::min(blockSamples, samples - first);
+                philox.normals(first, count, 0, normals.data());
+                blockSums[block] = antithetic
+                        ? simulateBlock<true>(normals.data(), count, drift, diffusion)
+                        : simulateBlock<false>(normals.data(), count, drift, diffusion);
+            }
+        };
+        if (pool) {
+            pool->parallelFor(blocks, 1, simulateBlocks);
+        } else {
+            simulateBlocks(0, blocks);
+        }
+
+        Sums sums;
+        for (const Sums& block : blockSums) {
+            sums.add(block);
+        }
+        const double forward = static_cast<double>(stockPrice) *
+                               std::exp(static_cast<double>(intRate) * time);
+        return sums.estimate(control, forward, std::exp(-static_cast<double>(intRate) * time));
+    }
+
+    /**
+     * Estimates the price with crude Monte Carlo from Philox streams, estimate without
+     * variance reduction.
+     *
+     * @param seed Seed of the Philox generator.
+     * @param pool Threads to simulate the blocks on, nullptr for the calling thread only.
+     * @return The estimated price of the option.
+     */
+    Real price(std::uint64_t seed, ThreadPool* pool = nullptr) const {
+        return static_cast<Real>(estimate(seed, VarianceReduction::None, pool).price);
+    }
+};
+
+/**
+ * The call and the put of one strike priced from the same paths.
+ */
+struct CallPutEstimate {
+    MonteCarloEstimate call;
+    MonteCarloEstimate put;
+};
+
+/**
+ * Monte Carlo estimate of the calls and puts of a whole strip of strikes from one simulation.
+ * Each block's stock prices at expiration are computed once, with the drift and diffusion
+ * worked out before the loop and the vectorized stepPaths, and every strike's call and put
+ * payoffs are then summed from them while the block is in the cache.
+ *
+ * Sharing the paths makes the call and the put of a strike differ by exactly the sample's
+ * forward less the strike: call - put = e^(-rT) (mean(S_T) - K) up to rounding, where separate
+ * simulations would differ by their independent errors. With the control variate the slopes
+ * of the call and the put on S_T differ by exactly 1, which takes mean(S_T) out and makes
+ * put-call parity hold to rounding, call - put = S - K e^(-rT).
+ *
+ * The blocks and their Philox streams are those of MonteCarloEngine, so each price is the one
+ * MonteCarloEngine gives for the same seed, but for the last bits of the vectorized e^x.
+ */
+class MonteCarloStripEngine {
+private:
+    double stockPrice;
+    double volatility;
+    double time;
+    double intRate;
+    int simulations;
+
+    /**
+     * Sums of one strike's payoff over the samples of a block, from the stock prices at
+     * expiration and, with antithetic variates, those of the mirrored paths.
+     */
+    template<class Payoff>
+    static MonteCarloSums strikeSums(const double* stockPrices, const double* mirrorPrices,
+                                     std::size_t count, double strikePrice) {
+        MonteCarloSums sums;
+        for (std::size_t i = 0; i < count; i++) {
+            double payoff = Payoff::payout(stockPrices[i], strikePrice);
+            if (mirrorPrices) {
+                sums.addPair(payoff, stockPrices[i], Payoff::payout(mirrorPrices[i], strikePrice),
+                             mirrorPrices[i]);
+            } else {
+                sums.addPath(payoff, stockPrices[i]);
+            }
+        }
+        return sums;
+    }
+
+public:
+    MonteCarloStripEngine(double stockPrice, double volatility, double time, double intRate,
+                          int simulations)
+            : stockPrice(stockPrice), volatility(volatility), time(time), intRate(intRate),
+              simulations(simulations) { }
+
+    /**
+     * Estimates the call and the put of every strike in one pass over the paths.
+     *
+     * @param strikePrices Strike prices to price.
+     * @param seed Seed of the Philox generator.
+     * @param reduction Variance reduction to apply, the same for every strike.
+     * @param pool Threads to simulate the blocks on, nullptr for the calling thread only.
+     * @return The call and the put of each strike, in the order of strikePrices.
+     */
+    std::vector<CallPutEstimate> estimate(const std::vector<double>& strikePrices,
+                                          std::uint64_t seed,
+                                          VarianceReduction reduction = VarianceReduction::None,
+                                          ThreadPool* pool = nullptr) const {
+        const bool antithetic = reduction == VarianceReduction::Antithetic ||
+                                reduction == VarianceReduction::AntitheticControlVariate;
+        const bool control = reduction == VarianceReduction::ControlVariate ||
+                             reduction == VarianceReduction::AntitheticControlVariate;
+        const std::size_t samples = antithetic ? (simulations + 1) / 2 : simulations;
+        const std::size_t blockSamples = 4096;
+        const std::size_t blocks = (samples + blockSamples - 1) / blockSamples;
+        const std::size_t strikes = strikePrices.size();
+        const Philox philox(seed);
+        const double drift = (intRate - 0.5 * volatility * volatility) * time;
+        const double diffusion = volatility * std::sqrt(time);
+
+        // the call and then the put of each strike, for each block
+        std::vector<MonteCarloSums> blockSums(blocks * 2 * strikes);
+        auto simulateBlocks = [&](std::size_t begin, std::size_t end) {
+            std::vector<double> normals(blockSamples), stockPrices(blockSamples);
+            std::vector<double> mirrorPrices(antithetic ? blockSamples : 0);
+            for (std::size_t block = begin; block < end; block++) {
+                std::size_t first = block * blockSamples;
+                std::size_t count = std::min(blockSamples, samples - first);
+                philox.normals(first, count, 0, normals.data());
+                std::fill(stockPrices.begin(), stockPrices.begin() + count, stockPrice);
+                stepPaths(stockPrices.data(), normals.data(), count, drift, diffusion);
+                if (antithetic) {
+                    std::fill(mirrorPrices.begin(), mirrorPrices.begin() + count, stockPrice);
+                    stepPaths(mirrorPrices.data(), normals.data(), count, drift, -diffusion);
+                }
+                const double* mirrors = antithetic ? mirrorPrices.data() : nullptr;
+                MonteCarloSums* sums = &blockSums[block * 2 * strikes];
+                for (std::size_t k = 0; k < strikes; k++) {
+                    sums[2 * k] = strikeSums<CallPayoff>(stockPrices.data(), mirrors, count,
+                                                         strikePrices[k]);
+                    sums[2 * k + 1] = strikeSums<PutPayoff>(stockPrices.data(), mirrors, count,
+                                                            strikePrices[k]);
+                }
+            }
+        };
+        if (pool) {
+            pool->parallelFor(blocks, 1, simulateBlocks);
+        } else {
+            simulateBlocks(0, blocks);
+        }
+
+        const double forward = stockPrice * std::exp(intRate * time);
+        const double discount = std::exp(-intRate * time);
+        std::vector<CallPutEstimate> results(strikes);
+        for (std::size_t k = 0; k < strikes; k++) {
+            MonteCarloSums call, put;
+            for (std::size_t block = 0; block < blocks; block++) {
+                call.add(blockSums[block * 2 * strikes + 2 * k]);
+                put.add(blockSums[block * 2 * strikes + 2 * k + 1]);
+            }
+            results[k] = {call.estimate(control, forward, discount),
+                          put.estimate(control, forward, discount)};
+        }
+        return results;
+    }
+};
+
+/**
+ * Cox-Ross-Rubinstein binomial lattice on the kernels of LatticeKernels.h, which have double and
+ * float versions for each instruction set. The stock prices of the last level are kept in an
+ * array and those of an earlier level are the same array times a growth factor. The lattice
+ * parameters are worked out and passed to the kernels in double whatever the engine's type: in
+ * float the probability of an up move, (e^(r dt) - d) / (u - d), would lose most of its digits
+ * to the cancellations and bias every step the same way. The arrays are kept between prices.
+ */
+template<class Payoff, class Exercise, class Real = double>
+class BinomialEngine {
+private:
+    double strikePrice;
+    int steps;
+    double upSz;
+    double upWeight;   // discounted probability of an up move
+    double downWeight; // discounted probability of a down move
+    std::vector<Real> values;
+    std::vector<Real> stockPrices;
+
+public:
+    /**
+     * @param steps Number of time steps in the lattice.
+     */
+    BinomialEngine(double stockPrice, double volatility, double strikePrice, double time,
+                   double intRate, int steps)
+            : strikePrice(strikePrice), steps(steps), values(steps + 1), stockPrices(steps + 1) {
+        double stepSize = time / steps;
+        double up = std::exp(volatility * std::sqrt(stepSize));
+        double down = 1 / up;
+        double upMv = (std::exp(intRate * stepSize) - down) / (up - down);
+        double discount = std::exp(-intRate * stepSize);
+        upSz = up;
+        upWeight = discount * upMv;
+        downWeight = discount * (1 - upMv);
+
+        // node j of the last level is the stock after j up and steps - j down moves
+        for (int j = 0; j <= steps; j++) {
+            stockPrices[j] = static_cast<Real>(stockPrice * std::pow(up, 2 * j - steps));
+        }
+    }
+
+    /**
+     * @return The price of the option.
+     */
+    Real price() {
+        for (int j = 0; j <= steps; j++) {
+            values[j] = Payoff::payout(stockPrices[j], static_cast<Real>(strikePrice));
+        }
+        double growth = 1;
+        for (int level = steps - 1; level >= 0; level--) {
+            growth *= upSz;
+            if constexpr (Exercise::early) {
+                rollbackExerciseLevel(values.data(), stockPrices.data(), level + 1, growth,
+                                      strikePrice, Payoff::sign, upWeight, downWeight);
+            } else {
+                rollbackLevel(values.data(), level + 1, upWeight, downWeight);
+            }
+        }
+        return values[0];
+    }
+};
+
+#endif //OPTIONSTRACKER_PRICINGENGINES_H
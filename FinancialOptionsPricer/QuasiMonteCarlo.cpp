@@ -0,0 +1,116 @@
+#include "QuasiMonteCarlo.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "BrownianBridge.h"
+#include "NormalDistribution.h"
+#include "Philox.h"
+#include "Sobol.h"
+#include "ThreadPool.h"
+
+QuasiMonteCarlo::QuasiMonteCarlo(double stockPrice, double volatility, double strikePrice,
+                                 double time, double intRate, int paths, std::uint64_t seed,
+                                 int replicates, ThreadPool* pool)
+        : Option(stockPrice, volatility, strikePrice, time, intRate), paths(paths), seed(seed),
+          replicates(replicates), pool(pool) {
+    if (replicates < 2) {
+        throw std::invalid_argument("Quasi-Monte Carlo needs at least two replicates");
+    }
+    if (paths < replicates) {
+        throw std::invalid_argument("Quasi-Monte Carlo needs a path for every replicate");
+    }
+}
+
+double QuasiMonteCarlo::callOptionPrice() {
+    return estimate(OptionType::Call).price;
+}
+
+double QuasiMonteCarlo::putOptionPrice() {
+    return estimate(OptionType::Put).price;
+}
+
+MonteCarloEstimate QuasiMonteCarlo::estimate(OptionType type) const {
+    return simulate(type, 1);
+}
+
+MonteCarloEstimate QuasiMonteCarlo::asianEstimate(OptionType type, int averagingDates) const {
+    if (averagingDates < 1 || averagingDates > Sobol::maxDimensions) {
+        throw std::invalid_argument("An Asian option needs 1 to 1000 averaging dates");
+    }
+    return simulate(type, averagingDates);
+}
+
+/**
+ * Replicate r scrambles its sequence with the seed Philox(seed) draws from counter (r, 0, 3, 0),
+ * so a replicate's paths depend only on the seed and r, and the replicates' sums are added in
+ * order whichever thread computed them. The stock price on date i is
+ * S e^((r - vol^2 / 2) t_i + vol W(t_i)), W the bridge's path.
+ */
+MonteCarloEstimate QuasiMonteCarlo::simulate(OptionType type, int averagingDates) const {
+    const int replicatePaths = paths / replicates;
+    std::vector<double> times(averagingDates);
+    std::vector<double> drifts(averagingDates);
+    for (int i = 0; i < averagingDates; i++) {
+        times[i] = time * (i + 1) / averagingDates;
+        drifts[i] = (intRate - 0.5 * volatility * volatility) * times[i];
+    }
+    const BrownianBridge bridge(times);
+    const Philox philox(seed);
+    const double sign = type == OptionType::Call ? 1 : -1;
+    const double weight = stockPrice / averagingDates;
+
+    // per replicate, the sum of the payoffs and of their squares
+    std::vector<double> sums(replicates), squares(replicates);
+    auto simulateReplicates = [&](std::size_t begin, std::size_t end) {
+        std::vector<double> point(averagingDates), path(averagingDates);
+        for (std::size_t r = begin; r < end; r++) {
+            Philox::Block words = philox({static_cast<std::uint32_t>(r), 0, 3, 0});
+            Sobol sobol(averagingDates, words[0] | std::uint64_t(words[1]) << 32);
+            double sum = 0, square = 0;
+            for (int p = 0; p < replicatePaths; p++) {
+                sobol.next(point.data());
+                for (double& x : point) {
+                    x = normalQuantile(x);
+                }
+                bridge.build(point.data(), path.data());
+                double average = 0;
+                for (int i = 0; i < averagingDates; i++) {
+                    average += std::exp(drifts[i] + volatility * path[i]);
+                }
+                double payoff = std::max(sign * (weight * average - strikePrice), 0.0);
+                sum += payoff;
+                square += payoff * payoff;
+            }
+            sums[r] = sum;
+            squares[r] = square;
+        }
+    };
+    if (pool) {
+        pool->parallelFor(replicates, 1, simulateReplicates);
+    } else {
+        simulateReplicates(0, replicates);
+    }
+
+    const double discount = std::exp(-intRate * time);
+    double total = 0, totalSquares = 0, meanSquares = 0;
+    for (int r = 0; r < replicates; r++) {
+        double mean = sums[r] / replicatePaths;
+        total += sums[r];
+        totalSquares += squares[r];
+        meanSquares += mean * mean;
+    }
+    const double n = static_cast<double>(replicatePaths) * replicates;
+    const double mean = total / n;
+    const double replicateVariance = std::max(meanSquares - replicates * mean * mean, 0.0) /
+                                     (replicates - 1);
+    MonteCarloEstimate result;
+    result.price = mean * discount;
+    result.standardError = std::sqrt(replicateVariance / replicates) * discount;
+    result.paths = static_cast<std::size_t>(n);
+    const double pathVariance = (totalSquares - total * mean) / (n - 1) * discount * discount;
+    result.effectiveSpeedup = result.standardError > 0
+            ? pathVariance / (n * result.standardError * result.standardError)
+            : 0;
+    return result;
+}
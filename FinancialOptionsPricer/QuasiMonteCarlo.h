@@ -0,0 +1,70 @@
+#ifndef OPTIONSTRACKER_QUASIMONTECARLO_H
+#define OPTIONSTRACKER_QUASIMONTECARLO_H
+#include <cstdint>
+#include "Option.h"
+#include "PricingEngines.h"
+
+/**
+ * Randomized quasi-Monte Carlo pricing. The paths are driven by a scrambled Sobol sequence
+ * instead of random numbers, mapped to normal numbers by normalQuantile and to paths by a
+ * Brownian bridge, so for smooth payoffs the error falls nearly as 1/N rather than 1/sqrt(N).
+ *
+ * A single quasi-random estimate has no error bar, so the paths are split between a number of
+ * replicates, each with an independently scrambled sequence. Every replicate is an unbiased
+ * estimate and the spread of the replicates gives the standard error. Fewer replicates leave
+ * more paths to each and a lower error, but a rougher estimate of it; 16 is a fair balance.
+ * The sequence is at its most even over 2^m points, so paths / replicates should be a power
+ * of two.
+ *
+ * Besides the European option, which needs one dimension, prices the arithmetic average Asian
+ * option over equally spaced dates, one dimension per date.
+ */
+class QuasiMonteCarlo : public Option {
+private:
+    int paths;
+    std::uint64_t seed;
+    int replicates;
+    ThreadPool* pool;
+
+    MonteCarloEstimate simulate(OptionType type, int averagingDates) const;
+
+public:
+    /**
+     * @param paths Total number of paths over all replicates.
+     * @param seed Seed of the scrambles, the same seed gives the same prices whatever the pool.
+     * @param replicates Number of independent scrambles, at least 2.
+     * @param pool Threads to split the replicates between, nullptr for the calling thread only.
+     * @throws std::invalid_argument If there are fewer than 2 replicates or paths than
+     * replicates.
+     */
+    QuasiMonteCarlo(double stockPrice, double volatility, double strikePrice, double time,
+                    double intRate, int paths, std::uint64_t seed, int replicates = 16,
+                    ThreadPool* pool = nullptr);
+
+    double callOptionPrice() override;
+
+    double putOptionPrice() override;
+
+    /**
+     * Prices one side of the European option with its standard error, and the speedup over
+     * crude Monte Carlo: the variance of one path's discounted payoff over
+     * paths * standardError^2.
+     *
+     * @param type Whether to price the call or the put.
+     * @return The estimated price with its statistics.
+     */
+    MonteCarloEstimate estimate(OptionType type) const;
+
+    /**
+     * Prices one side of an Asian option paying the arithmetic average of the stock price on
+     * equally spaced dates, the last at expiration, less the strike.
+     *
+     * @param type Whether to price the call or the put.
+     * @param averagingDates Number of dates averaged over, 1 for the European option.
+     * @return The estimated price with its statistics.
+     * @throws std::invalid_argument If averagingDates is not between 1 and
+     * Sobol::maxDimensions.
+     */
+    MonteCarloEstimate asianEstimate(OptionType type, int averagingDates) const;
+};
+#endif //OPTIONSTRACKER_QUASIMONTECARLO_H
@@ -0,0 +1,59 @@
+#include <atomic>
+#include "Simd.h"
+
+// Set by the instruction set specific translation units, false when the compiler could not
+// build them with the instructions enabled.
+extern const bool avx2KernelsCompiled;
+extern const bool avx512KernelsCompiled;
+
+/**
+ * Checks the processor through the compiler's cpuid builtins, only GCC and Clang on x86 have
+ * them so every other build uses the scalar kernels.
+ *
+ * @return The best level supported by both the processor and the build.
+ */
+SimdLevel detectSimdLevel() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (avx512KernelsCompiled && __builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512dq")) {
+        return SimdLevel::AVX512;
+    }
+    if (avx2KernelsCompiled && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+/**
+ * @return The level the kernels dispatch to, detected the first time it is needed.
+ */
+static std::atomic<SimdLevel>& activeLevel() {
+    static std::atomic<SimdLevel> level(detectSimdLevel());
+    return level;
+}
+
+SimdLevel activeSimdLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    SimdLevel detected = detectSimdLevel();
+    if (static_cast<int>(level) > static_cast<int>(detected)) {
+        level = detected;
+    }
+    activeLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        default:
+            return "Scalar";
+    }
+}
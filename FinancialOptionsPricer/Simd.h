@@ -0,0 +1,45 @@
+#ifndef OPTIONSTRACKER_SIMD_H
+#define OPTIONSTRACKER_SIMD_H
+
+/**
+ * Instruction sets the vectorized kernels are compiled for. The kernels of every level are
+ * built into the program and the best one the processor supports is picked when the program
+ * runs, so the same executable runs on any x86-64 machine.
+ */
+enum class SimdLevel {
+    Scalar,
+    AVX2,
+    AVX512
+};
+
+/**
+ * Finds the highest instruction set supported by both the processor and the build.
+ *
+ * @return The best available level, Scalar when no vector kernels can be used.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * The instruction set the vectorized kernels currently dispatch to.
+ * Starts out as the detected level.
+ *
+ * @return The active level.
+ */
+SimdLevel activeSimdLevel();
+
+/**
+ * Selects the instruction set for the vectorized kernels, mostly so benchmarks can compare
+ * the levels. A level above the detected one is lowered to the detected one.
+ *
+ * @param level Requested level.
+ * @return The level that is active afterwards.
+ */
+SimdLevel setSimdLevel(SimdLevel level);
+
+/**
+ * @param level An instruction set level.
+ * @return A printable name for the level.
+ */
+const char* simdLevelName(SimdLevel level);
+
+#endif //OPTIONSTRACKER_SIMD_H
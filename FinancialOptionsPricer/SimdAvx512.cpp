@@ -0,0 +1,157 @@
+/**
+ * AVX-512 instantiations of the vectorized kernels. This file is compiled with AVX-512F and
+ * AVX-512DQ enabled, nothing in it runs unless detectSimdLevel found them on the processor.
+ */
+#include "SimdVec.h"
+#include "LatticeKernels.h"
+#include "BlackScholesKernels.h"
+#include "ImpliedVolatilityKernels.h"
+#include "PathKernels.h"
+#include "PhiloxKernels.h"
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+extern const bool avx512KernelsCompiled = true;
+
+namespace avx512 {
+    void rollbackLevel(double* values, int nodes, double upWeight, double downWeight) {
+        int i = rollbackLevelKernel<Avx512Vec>(values, 0, nodes, 1, upWeight, downWeight);
+        rollbackLevelKernel<ScalarVec>(values, i, nodes, 1, upWeight, downWeight);
+    }
+
+    void rollbackExerciseLevel(double* values, const double* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight, double downWeight) {
+        int i = rollbackExerciseLevelKernel<Avx512Vec>(values, stockPrices, 0, nodes, growth,
+                                                       strikePrice, sign, upWeight, downWeight);
+        rollbackExerciseLevelKernel<ScalarVec>(values, stockPrices, i, nodes, growth, strikePrice,
+                                               sign, upWeight, downWeight);
+    }
+
+    void rollbackLevel(float* values, int nodes, double upWeight, double downWeight) {
+        int i = rollbackLevelKernel<Avx512FloatVec>(values, 0, nodes, 1, upWeight, downWeight);
+        rollbackLevelKernel<ScalarFloatVec>(values, i, nodes, 1, upWeight, downWeight);
+    }
+
+    void rollbackExerciseLevel(float* values, const float* stockPrices, int nodes, double growth,
+                               double strikePrice, double sign, double upWeight,
+                               double downWeight) {
+        int i = rollbackExerciseLevelKernel<Avx512FloatVec>(values, stockPrices, 0, nodes,
+                                                            growth, strikePrice, sign, upWeight,
+                                                            downWeight);
+        rollbackExerciseLevelKernel<ScalarFloatVec>(values, stockPrices, i, nodes, growth,
+                                                    strikePrice, sign, upWeight, downWeight);
+    }
+
+    void rollbackInterleavedLevel(double* values, int nodes, int width, double upWeight,
+                                  double downWeight) {
+        int i = rollbackLevelKernel<Avx512Vec>(values, 0, nodes * width, width, upWeight, downWeight);
+        rollbackLevelKernel<ScalarVec>(values, i, nodes * width, width, upWeight, downWeight);
+    }
+
+    void rollbackInterleavedExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                          int width, const double* signs,
+                                          const double* signedStrikes, double growth,
+                                          double upWeight, double downWeight) {
+        int lane = rollbackInterleavedExerciseLevelKernel<Avx512Vec>(
+                values, stockPrices, nodes, width, 0, width, signs, signedStrikes, growth,
+                upWeight, downWeight);
+        rollbackInterleavedExerciseLevelKernel<ScalarVec>(values, stockPrices, nodes, width, lane,
+                                                          width, signs, signedStrikes, growth,
+                                                          upWeight, downWeight);
+    }
+
+    void rollbackTrinomialLevel(double* values, int nodes, double upWeight, double middleWeight,
+                                double downWeight) {
+        int i = rollbackTrinomialLevelKernel<Avx512Vec>(values, 0, nodes, upWeight,
+                                                        middleWeight, downWeight);
+        rollbackTrinomialLevelKernel<ScalarVec>(values, i, nodes, upWeight, middleWeight,
+                                                downWeight);
+    }
+
+    void rollbackTrinomialExerciseLevel(double* values, const double* stockPrices, int nodes,
+                                        double strikePrice, double sign, double upWeight,
+                                        double middleWeight, double downWeight) {
+        int i = rollbackTrinomialExerciseLevelKernel<Avx512Vec>(values, stockPrices, 0, nodes,
+                                                                strikePrice, sign, upWeight,
+                                                                middleWeight, downWeight);
+        rollbackTrinomialExerciseLevelKernel<ScalarVec>(values, stockPrices, i, nodes, strikePrice,
+                                                        sign, upWeight, middleWeight, downWeight);
+    }
+
+    void priceBlackScholes(const double* stockPrices, const double* volatilities,
+                           const double* strikePrices, const double* times, const double* intRates,
+                           const OptionType* types, std::size_t count, double* prices,
+                           NormalAccuracy accuracy) {
+        priceBlackScholesKernels<Avx512Vec, ScalarVec>(stockPrices, volatilities, strikePrices,
+                                                       times, intRates, types, count, prices,
+                                                       accuracy);
+    }
+
+    void priceBlackScholes(const float* stockPrices, const float* volatilities,
+                           const float* strikePrices, const float* times, const float* intRates,
+                           const OptionType* types, std::size_t count, float* prices,
+                           NormalAccuracy accuracy) {
+        priceBlackScholesKernels<Avx512FloatVec, ScalarFloatVec>(stockPrices, volatilities,
+                                                                 strikePrices, times, intRates,
+                                                                 types, count, prices, accuracy);
+    }
+
+    void normalCdf(const double* points, double* cdf, std::size_t count, NormalAccuracy accuracy) {
+        std::size_t i = normalCdfKernel<Avx512Vec>(points, cdf, 0, count, accuracy);
+        i = normalCdfKernel<Avx2Vec>(points, cdf, i, count, accuracy);
+        normalCdfKernel<ScalarVec>(points, cdf, i, count, accuracy);
+    }
+
+    void impliedVolatilities(const double* prices, const double* stockPrices,
+                             const double* strikePrices, const double* times,
+                             const double* intRates, const OptionType* types, std::size_t count,
+                             ImpliedVolatility* results) {
+        std::size_t i = impliedVolatilityKernel<Avx512Vec>(prices, stockPrices, strikePrices,
+                                                           times, intRates, types, 0, count,
+                                                           results);
+        i = impliedVolatilityKernel<Avx2Vec>(prices, stockPrices, strikePrices, times, intRates,
+                                             types, i, count, results);
+        impliedVolatilityKernel<ScalarVec>(prices, stockPrices, strikePrices, times, intRates,
+                                           types, i, count, results);
+    }
+
+    void stepPaths(double* stockPrices, const double* normals, std::size_t count, double drift,
+                   double diffusion) {
+        std::size_t i = stepPathsKernel<Avx512Vec>(stockPrices, normals, 0, count, drift, diffusion);
+        stepPathsKernel<ScalarVec>(stockPrices, normals, i, count, drift, diffusion);
+    }
+
+    void philoxNormals(std::uint32_t key0, std::uint32_t key1, std::uint64_t firstGroup,
+                       std::size_t groups, std::uint32_t draw, double* normals) {
+        philoxNormalsKernel<Avx512Vec>(key0, key1, firstGroup, 0, groups, draw, normals);
+    }
+}
+#else
+extern const bool avx512KernelsCompiled = false;
+
+// Never called, detectSimdLevel does not report AVX-512 when the kernels were not compiled.
+namespace avx512 {
+    void rollbackLevel(double*, int, double, double) {}
+    void rollbackExerciseLevel(double*, const double*, int, double, double, double, double,
+                               double) {}
+    void rollbackLevel(float*, int, double, double) {}
+    void rollbackExerciseLevel(float*, const float*, int, double, double, double, double,
+                               double) {}
+    void rollbackInterleavedLevel(double*, int, int, double, double) {}
+    void rollbackInterleavedExerciseLevel(double*, const double*, int, int, const double*,
+                                          const double*, double, double, double) {}
+    void rollbackTrinomialLevel(double*, int, double, double, double) {}
+    void rollbackTrinomialExerciseLevel(double*, const double*, int, double, double, double,
+                                        double, double) {}
+    void priceBlackScholes(const double*, const double*, const double*, const double*,
+                           const double*, const OptionType*, std::size_t, double*,
+                           NormalAccuracy) {}
+    void priceBlackScholes(const float*, const float*, const float*, const float*, const float*,
+                           const OptionType*, std::size_t, float*, NormalAccuracy) {}
+    void normalCdf(const double*, double*, std::size_t, NormalAccuracy) {}
+    void impliedVolatilities(const double*, const double*, const double*, const double*,
+                             const double*, const OptionType*, std::size_t, ImpliedVolatility*) {}
+    void stepPaths(double*, const double*, std::size_t, double, double) {}
+    void philoxNormals(std::uint32_t, std::uint32_t, std::uint64_t, std::size_t, std::uint32_t,
+                       double*) {}
+}
+#endif
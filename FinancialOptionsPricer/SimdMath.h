@@ -0,0 +1,210 @@
+#ifndef OPTIONSTRACKER_SIMDMATH_H
+#define OPTIONSTRACKER_SIMDMATH_H
+
+/**
+ * Elementary functions over the register wrappers of SimdVec.h, so vectorized kernels do not
+ * have to leave their registers for std::exp and friends. Each is a template over the wrapper
+ * type and evaluates every lane with the same branch free sequence of operations.
+ */
+
+#include <cmath>
+#include "SimdVec.h"
+
+/**
+ * One value at a time the standard library is faster than the branch free polynomials, so the
+ * scalar fallback and the ends of arrays use it. Being declared before the templates, these
+ * overloads are picked over them wherever the templates call the functions with a ScalarVec.
+ */
+inline ScalarVec simdExp(ScalarVec x) { return {std::exp(x.v)}; }
+inline ScalarVec simdLog(ScalarVec x) { return {std::log(x.v)}; }
+inline ScalarVec simdNormalCdf(ScalarVec x) { return {0.5 * std::erfc(-x.v * 0.7071067811865476)}; }
+inline ScalarFloatVec simdExp(ScalarFloatVec x) { return {std::exp(x.v)}; }
+inline ScalarFloatVec simdLog(ScalarFloatVec x) { return {std::log(x.v)}; }
+inline ScalarFloatVec simdNormalCdf(ScalarFloatVec x) {
+    return {0.5f * std::erfc(-x.v * 0.70710677f)};
+}
+
+/**
+ * Whether the lanes of a register wrapper are floats, whose functions need fewer terms and a
+ * narrower range than those of doubles.
+ */
+template<class V>
+constexpr bool isFloatVec() {
+    return sizeof(typename V::Scalar) == sizeof(float);
+}
+
+// 1 / k!, the Taylor coefficients of e^x
+static constexpr double inverseFactorials[] = {
+        1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0,
+        1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0,
+        1.0 / 6227020800.0};
+
+/**
+ * Horner evaluation of the Taylor terms of e^r from the k-th to the given degree, divided by
+ * r^k. Recursing at compile time leaves one fmadd per term and no loop.
+ */
+template<int k, int degree, class V>
+V expTaylorTerms(V r) {
+    if constexpr (k == degree) {
+        return V::broadcast(inverseFactorials[k]);
+    } else {
+        return fmadd(expTaylorTerms<k + 1, degree>(r), r, V::broadcast(inverseFactorials[k]));
+    }
+}
+
+/**
+ * e^x. Splits x into n * ln 2 + r with |r| <= ln 2 / 2, so e^x is 2^n times a Taylor
+ * polynomial of e^r. ln 2 is split in two parts whose first has few enough bits that n * ln 2
+ * is exact. The polynomial has the given degree, up to 13, and the relative error is about
+ * 0.35^(degree + 1) / (degree + 1)!, so callers that need less than full accuracy can evaluate
+ * fewer terms. Inputs below -708 give 0, inputs above 709 give e^709; for floats the limits
+ * are -87 and 88.
+ */
+template<int degree, class V>
+V simdExpTaylor(V x) {
+    static_assert(degree >= 1 && degree <= 13, "no Taylor coefficients for this degree");
+    const V tiny = V::broadcast(isFloatVec<V>() ? -87.0 : -708.0);
+    const V clamped = min(max(x, tiny), V::broadcast(isFloatVec<V>() ? 88.0 : 709.0));
+    const V n = roundNearest(clamped * V::broadcast(1.4426950408889634));
+    V r = fmadd(n, V::broadcast(-6.93145751953125e-1), clamped);
+    r = fmadd(n, V::broadcast(-1.42860682030941723212e-6), r);
+
+    return select(lessThan(x, tiny), V::broadcast(0.0), expTaylorTerms<0, degree>(r) * pow2(n));
+}
+
+/**
+ * e^x accurate to one unit in the last place, simdExpTaylor with all 13 terms for doubles and
+ * 7 for floats.
+ */
+template<class V>
+V simdExp(V x) {
+    return simdExpTaylor<isFloatVec<V>() ? 7 : 13>(x);
+}
+
+/**
+ * Natural logarithm of a positive normal number. x = 2^e * m with m in [sqrt(1/2), sqrt(2)),
+ * and ln m = 2 atanh(f) with f = (m - 1) / (m + 1), whose odd series converges quickly since
+ * |f| < 0.172. Accurate to one unit in the last place. Floats stop the series at f^9 / 9, the
+ * terms after it being below their precision.
+ */
+template<class V>
+V simdLog(V x) {
+    const V one = V::broadcast(1.0);
+    V exponent = exponentOf(x);
+    V mantissa = mantissaOf(x);
+    auto high = lessThan(V::broadcast(1.4142135623730951), mantissa);
+    mantissa = select(high, mantissa * V::broadcast(0.5), mantissa);
+    exponent = select(high, exponent + one, exponent);
+
+    const V f = (mantissa - one) / (mantissa + one);
+    const V s = f * f;
+    V p = V::broadcast(1.0 / 9.0);
+    if constexpr (!isFloatVec<V>()) {
+        p = V::broadcast(1.0 / 23.0);
+        p = fmadd(p, s, V::broadcast(1.0 / 21.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 19.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 17.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 15.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 13.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 11.0));
+        p = fmadd(p, s, V::broadcast(1.0 / 9.0));
+    }
+    p = fmadd(p, s, V::broadcast(1.0 / 7.0));
+    p = fmadd(p, s, V::broadcast(1.0 / 5.0));
+    p = fmadd(p, s, V::broadcast(1.0 / 3.0));
+    p = fmadd(p, s, one);
+    V logMantissa = (f + f) * p;
+    return fmadd(exponent, V::broadcast(6.93145751953125e-1),
+                 fmadd(exponent, V::broadcast(1.42860682030941723212e-6), logMantissa));
+}
+
+/**
+ * Standard normal cumulative distribution function, the same as 0.5 * erfc(-x / sqrt(2)).
+ * Uses Hart's double precision algorithm as given by West (2005): a rational function times
+ * e^(-x^2 / 2) for |x| < 7.07 and a continued fraction beyond it, for the lower tail of |x|,
+ * mirrored for positive x. Both pieces are computed for every lane and the right one kept.
+ * The absolute error is below 3e-16 everywhere. Relative to the tiny tail probabilities
+ * beyond |x| = 4 it grows to about 1e-8, which no price built from it can notice.
+ */
+template<class V>
+V simdNormalCdf(V x) {
+    const V z = abs(x);
+    const V gaussian = simdExp(V::broadcast(-0.5) * z * z);
+
+    V numerator = V::broadcast(3.52624965998911e-2);
+    numerator = fmadd(numerator, z, V::broadcast(0.700383064443688));
+    numerator = fmadd(numerator, z, V::broadcast(6.37396220353165));
+    numerator = fmadd(numerator, z, V::broadcast(33.912866078383));
+    numerator = fmadd(numerator, z, V::broadcast(112.079291497871));
+    numerator = fmadd(numerator, z, V::broadcast(221.213596169931));
+    numerator = fmadd(numerator, z, V::broadcast(220.206867912376));
+    V denominator = V::broadcast(8.83883476483184e-2);
+    denominator = fmadd(denominator, z, V::broadcast(1.75566716318264));
+    denominator = fmadd(denominator, z, V::broadcast(16.064177579207));
+    denominator = fmadd(denominator, z, V::broadcast(86.7807322029461));
+    denominator = fmadd(denominator, z, V::broadcast(296.564248779674));
+    denominator = fmadd(denominator, z, V::broadcast(637.333633378831));
+    denominator = fmadd(denominator, z, V::broadcast(793.826512519948));
+    denominator = fmadd(denominator, z, V::broadcast(440.413735824752));
+    const V central = gaussian * numerator / denominator;
+
+    V fraction = z + V::broadcast(0.65);
+    fraction = z + V::broadcast(4.0) / fraction;
+    fraction = z + V::broadcast(3.0) / fraction;
+    fraction = z + V::broadcast(2.0) / fraction;
+    fraction = z + V::broadcast(1.0) / fraction;
+    const V tail = gaussian / (fraction * V::broadcast(2.506628274631));
+
+    V lower = select(lessThan(z, V::broadcast(7.07106781186547)), central, tail);
+    lower = select(lessThan(V::broadcast(37.0), z), V::broadcast(0.0), lower);
+    return select(lessThan(V::broadcast(0.0), x), V::broadcast(1.0) - lower, lower);
+}
+
+/**
+ * Inverse of the standard normal cumulative distribution function for p in (0, 1), with
+ * Acklam's rational approximations: one in p - 1/2 for the central region and one in
+ * sqrt(-2 ln p) for the tails, mirrored for the upper tail. The result has a relative error
+ * below 1.2e-9.
+ */
+template<class V>
+V simdNormalQuantile(V p) {
+    const V half = V::broadcast(0.5);
+    const V one = V::broadcast(1.0);
+    const auto upper = lessThan(half, p);
+    const V tailP = min(p, one - p);
+
+    const V q = sqrt(V::broadcast(-2.0) * simdLog(tailP));
+    V numerator = V::broadcast(-7.784894002430293e-03);
+    numerator = fmadd(numerator, q, V::broadcast(-3.223964580411365e-01));
+    numerator = fmadd(numerator, q, V::broadcast(-2.400758277161838e+00));
+    numerator = fmadd(numerator, q, V::broadcast(-2.549732539343734e+00));
+    numerator = fmadd(numerator, q, V::broadcast(4.374664141464968e+00));
+    numerator = fmadd(numerator, q, V::broadcast(2.938163982698783e+00));
+    V denominator = V::broadcast(7.784695709041462e-03);
+    denominator = fmadd(denominator, q, V::broadcast(3.224671290700398e-01));
+    denominator = fmadd(denominator, q, V::broadcast(2.445134137142996e+00));
+    denominator = fmadd(denominator, q, V::broadcast(3.754408661907416e+00));
+    denominator = fmadd(denominator, q, one);
+    const V tail = numerator / denominator;
+
+    const V c = p - half;
+    const V r = c * c;
+    numerator = V::broadcast(-3.969683028665376e+01);
+    numerator = fmadd(numerator, r, V::broadcast(2.209460984245205e+02));
+    numerator = fmadd(numerator, r, V::broadcast(-2.759285104469687e+02));
+    numerator = fmadd(numerator, r, V::broadcast(1.383577518672690e+02));
+    numerator = fmadd(numerator, r, V::broadcast(-3.066479806614716e+01));
+    numerator = fmadd(numerator, r, V::broadcast(2.506628277459239e+00));
+    denominator = V::broadcast(-5.447609879822406e+01);
+    denominator = fmadd(denominator, r, V::broadcast(1.615858368580409e+02));
+    denominator = fmadd(denominator, r, V::broadcast(-1.556989798598866e+02));
+    denominator = fmadd(denominator, r, V::broadcast(6.680131188771972e+01));
+    denominator = fmadd(denominator, r, V::broadcast(-1.328068155288572e+01));
+    denominator = fmadd(denominator, r, one);
+    const V central = numerator * c / denominator;
+
+    const V lowerTail = select(upper, V::broadcast(0.0) - tail, tail);
+    return select(lessThan(tailP, V::broadcast(0.02425)), lowerTail, central);
+}
+
+#endif //OPTIONSTRACKER_SIMDMATH_H
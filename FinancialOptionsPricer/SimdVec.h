@@ -0,0 +1,457 @@
+#ifndef OPTIONSTRACKER_SIMDVEC_H
+#define OPTIONSTRACKER_SIMDVEC_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Thin wrappers around one SIMD register of doubles or of floats. The vectorized kernels are
+ * templates over these types, written once and compiled once per instruction set. The
+ * translation unit of each instruction set is built with its compiler flags, so a wrapper is
+ * only defined where the compiler can generate its instructions.
+ *
+ * Every wrapper has the same interface: width, the Scalar type of a lane, a Mask type for the
+ * result of a comparison, load / store of unaligned memory, broadcast of a scalar, arithmetic
+ * operators, fmadd, min, max, lessThan and select, plus the building blocks of the math
+ * functions in SimdMath.h: abs, sqrt, roundNearest, pow2 (2^n for a whole number n between
+ * -1022 and 1023, -126 and 127 for floats), and exponentOf / mantissaOf, which split a positive
+ * normal number into its binary exponent and a mantissa in [1, 2). A float register holds twice
+ * the lanes of a double one, for pricing where float precision is enough.
+ *
+ * Each double wrapper also names, as Words, a register of the same number of 64 bit lanes
+ * holding one 32 bit word each, for the random number generator of Philox.h: broadcast, iota
+ * (consecutive numbers from a start), xor, low32 / high32, mulWide (the 64 bit product of the
+ * low words) and uniformOf, which turns each word w into the double (w + 1/2) / 2^32.
+ *
+ * The wrappers live in an unnamed namespace so each translation unit gets its own copy. The
+ * kernels instantiated with them then can't be merged by the linker with a copy compiled for
+ * another instruction set, which would run AVX instructions in the scalar fallback.
+ */
+namespace {
+
+/**
+ * A single double, used by the scalar fallback and for the ends of arrays that do not fill a
+ * whole register.
+ */
+struct ScalarWords;
+
+struct ScalarVec {
+    static constexpr int width = 1;
+    typedef double Scalar;
+    typedef bool Mask;
+    typedef ScalarWords Words;
+    double v;
+
+    static ScalarVec load(const double* p) { return {*p}; }
+    static ScalarVec broadcast(double x) { return {x}; }
+    void store(double* p) const { *p = v; }
+};
+
+inline ScalarVec operator+(ScalarVec a, ScalarVec b) { return {a.v + b.v}; }
+inline ScalarVec operator-(ScalarVec a, ScalarVec b) { return {a.v - b.v}; }
+inline ScalarVec operator*(ScalarVec a, ScalarVec b) { return {a.v * b.v}; }
+inline ScalarVec operator/(ScalarVec a, ScalarVec b) { return {a.v / b.v}; }
+// a * b + c
+inline ScalarVec fmadd(ScalarVec a, ScalarVec b, ScalarVec c) { return {a.v * b.v + c.v}; }
+inline ScalarVec min(ScalarVec a, ScalarVec b) { return {std::min(a.v, b.v)}; }
+inline ScalarVec max(ScalarVec a, ScalarVec b) { return {std::max(a.v, b.v)}; }
+inline bool lessThan(ScalarVec a, ScalarVec b) { return a.v < b.v; }
+// a where the mask is set, b elsewhere, blended through the bits so that no branch can be
+// mispredicted on data with random masks
+inline ScalarVec select(bool mask, ScalarVec a, ScalarVec b) {
+    std::uint64_t bitsA, bitsB;
+    std::memcpy(&bitsA, &a.v, sizeof(bitsA));
+    std::memcpy(&bitsB, &b.v, sizeof(bitsB));
+    std::uint64_t keepA = 0 - static_cast<std::uint64_t>(mask);
+    std::uint64_t bits = (bitsA & keepA) | (bitsB & ~keepA);
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+inline ScalarVec abs(ScalarVec a) { return {std::fabs(a.v)}; }
+inline ScalarVec sqrt(ScalarVec a) { return {std::sqrt(a.v)}; }
+// adding and subtracting 1.5 * 2^52 rounds to a whole number without a call to the library
+inline ScalarVec roundNearest(ScalarVec a) {
+    return {(a.v + 6755399441055744.0) - 6755399441055744.0};
+}
+inline ScalarVec pow2(ScalarVec n) {
+    std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(n.v) + 1023) << 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+inline ScalarVec exponentOf(ScalarVec a) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &a.v, sizeof(bits));
+    return {static_cast<double>(static_cast<std::int64_t>(bits >> 52) - 1023)};
+}
+inline ScalarVec mantissaOf(ScalarVec a) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &a.v, sizeof(bits));
+    bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+
+/**
+ * A single 32 bit word in 64 bits.
+ */
+struct ScalarWords {
+    std::uint64_t v;
+
+    static ScalarWords broadcast(std::uint64_t x) { return {x}; }
+    static ScalarWords iota(std::uint64_t first) { return {first}; }
+};
+
+inline ScalarWords operator^(ScalarWords a, ScalarWords b) { return {a.v ^ b.v}; }
+inline ScalarWords low32(ScalarWords a) { return {a.v & 0xFFFFFFFFull}; }
+inline ScalarWords high32(ScalarWords a) { return {a.v >> 32}; }
+inline ScalarWords mulWide(ScalarWords a, ScalarWords b) {
+    return {(a.v & 0xFFFFFFFFull) * (b.v & 0xFFFFFFFFull)};
+}
+inline ScalarVec uniformOf(ScalarWords a) {
+    return {(static_cast<double>(a.v) + 0.5) * 2.3283064365386963e-10};
+}
+
+/**
+ * A single float, the scalar fallback and tail of the float kernels.
+ */
+struct ScalarFloatVec {
+    static constexpr int width = 1;
+    typedef float Scalar;
+    typedef bool Mask;
+    float v;
+
+    static ScalarFloatVec load(const float* p) { return {*p}; }
+    static ScalarFloatVec broadcast(float x) { return {x}; }
+    void store(float* p) const { *p = v; }
+};
+
+inline ScalarFloatVec operator+(ScalarFloatVec a, ScalarFloatVec b) { return {a.v + b.v}; }
+inline ScalarFloatVec operator-(ScalarFloatVec a, ScalarFloatVec b) { return {a.v - b.v}; }
+inline ScalarFloatVec operator*(ScalarFloatVec a, ScalarFloatVec b) { return {a.v * b.v}; }
+inline ScalarFloatVec operator/(ScalarFloatVec a, ScalarFloatVec b) { return {a.v / b.v}; }
+inline ScalarFloatVec fmadd(ScalarFloatVec a, ScalarFloatVec b, ScalarFloatVec c) {
+    return {a.v * b.v + c.v};
+}
+inline ScalarFloatVec min(ScalarFloatVec a, ScalarFloatVec b) { return {std::min(a.v, b.v)}; }
+inline ScalarFloatVec max(ScalarFloatVec a, ScalarFloatVec b) { return {std::max(a.v, b.v)}; }
+inline bool lessThan(ScalarFloatVec a, ScalarFloatVec b) { return a.v < b.v; }
+inline ScalarFloatVec select(bool mask, ScalarFloatVec a, ScalarFloatVec b) {
+    std::uint32_t bitsA, bitsB;
+    std::memcpy(&bitsA, &a.v, sizeof(bitsA));
+    std::memcpy(&bitsB, &b.v, sizeof(bitsB));
+    std::uint32_t keepA = 0 - static_cast<std::uint32_t>(mask);
+    std::uint32_t bits = (bitsA & keepA) | (bitsB & ~keepA);
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+inline ScalarFloatVec abs(ScalarFloatVec a) { return {std::fabs(a.v)}; }
+inline ScalarFloatVec sqrt(ScalarFloatVec a) { return {std::sqrt(a.v)}; }
+// the float version of the trick, with 1.5 * 2^23
+inline ScalarFloatVec roundNearest(ScalarFloatVec a) {
+    return {(a.v + 12582912.0f) - 12582912.0f};
+}
+inline ScalarFloatVec pow2(ScalarFloatVec n) {
+    std::uint32_t bits = static_cast<std::uint32_t>(static_cast<std::int32_t>(n.v) + 127) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+inline ScalarFloatVec exponentOf(ScalarFloatVec a) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &a.v, sizeof(bits));
+    return {static_cast<float>(static_cast<std::int32_t>(bits >> 23) - 127)};
+}
+inline ScalarFloatVec mantissaOf(ScalarFloatVec a) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &a.v, sizeof(bits));
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return {result};
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+/**
+ * Four doubles in an AVX2 register.
+ */
+struct Avx2Words;
+
+struct Avx2Vec {
+    static constexpr int width = 4;
+    typedef double Scalar;
+    typedef __m256d Mask;
+    typedef Avx2Words Words;
+    __m256d v;
+
+    static Avx2Vec load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    static Avx2Vec broadcast(double x) { return {_mm256_set1_pd(x)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+
+inline Avx2Vec operator+(Avx2Vec a, Avx2Vec b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline Avx2Vec operator-(Avx2Vec a, Avx2Vec b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline Avx2Vec operator*(Avx2Vec a, Avx2Vec b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline Avx2Vec operator/(Avx2Vec a, Avx2Vec b) { return {_mm256_div_pd(a.v, b.v)}; }
+inline Avx2Vec fmadd(Avx2Vec a, Avx2Vec b, Avx2Vec c) { return {_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+inline Avx2Vec min(Avx2Vec a, Avx2Vec b) { return {_mm256_min_pd(a.v, b.v)}; }
+inline Avx2Vec max(Avx2Vec a, Avx2Vec b) { return {_mm256_max_pd(a.v, b.v)}; }
+inline __m256d lessThan(Avx2Vec a, Avx2Vec b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+inline Avx2Vec select(__m256d mask, Avx2Vec a, Avx2Vec b) {
+    return {_mm256_blendv_pd(b.v, a.v, mask)};
+}
+inline Avx2Vec abs(Avx2Vec a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+inline Avx2Vec sqrt(Avx2Vec a) { return {_mm256_sqrt_pd(a.v)}; }
+inline Avx2Vec roundNearest(Avx2Vec a) {
+    return {_mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+// Adding 1.5 * 2^52 puts the whole number n in the low bits of the mantissa, so its bits plus
+// the exponent bias shifted into the exponent field are 2^n.
+inline Avx2Vec pow2(Avx2Vec n) {
+    __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n.v, _mm256_set1_pd(6755399441055744.0)));
+    bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+    return {_mm256_castsi256_pd(bits)};
+}
+// The biased exponent placed in the mantissa of 2^52 gives 2^52 + exponent + 1023.
+inline Avx2Vec exponentOf(Avx2Vec a) {
+    __m256i bits = _mm256_srli_epi64(_mm256_castpd_si256(a.v), 52);
+    bits = _mm256_or_si256(bits, _mm256_set1_epi64x(0x4330000000000000ll));
+    return {_mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(4503599627371519.0))};
+}
+inline Avx2Vec mantissaOf(Avx2Vec a) {
+    __m256i bits = _mm256_and_si256(_mm256_castpd_si256(a.v),
+                                    _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll));
+    bits = _mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000ll));
+    return {_mm256_castsi256_pd(bits)};
+}
+/**
+ * Four 32 bit words in the 64 bit lanes of an AVX2 register, the layout mul_epu32 multiplies.
+ */
+struct Avx2Words {
+    __m256i v;
+
+    static Avx2Words broadcast(std::uint64_t x) {
+        return {_mm256_set1_epi64x(static_cast<long long>(x))};
+    }
+    static Avx2Words iota(std::uint64_t first) {
+        return {_mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(first)),
+                                 _mm256_setr_epi64x(0, 1, 2, 3))};
+    }
+};
+
+inline Avx2Words operator^(Avx2Words a, Avx2Words b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline Avx2Words low32(Avx2Words a) {
+    return {_mm256_and_si256(a.v, _mm256_set1_epi64x(0xFFFFFFFFll))};
+}
+inline Avx2Words high32(Avx2Words a) { return {_mm256_srli_epi64(a.v, 32)}; }
+inline Avx2Words mulWide(Avx2Words a, Avx2Words b) { return {_mm256_mul_epu32(a.v, b.v)}; }
+// the word in the mantissa of 2^52 gives 2^52 + w exactly, as in exponentOf
+inline Avx2Vec uniformOf(Avx2Words a) {
+    __m256i bits = _mm256_or_si256(a.v, _mm256_set1_epi64x(0x4330000000000000ll));
+    __m256d word = _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(4503599627370496.0));
+    return {_mm256_mul_pd(_mm256_add_pd(word, _mm256_set1_pd(0.5)),
+                          _mm256_set1_pd(2.3283064365386963e-10))};
+}
+
+/**
+ * Eight floats in an AVX2 register.
+ */
+struct Avx2FloatVec {
+    static constexpr int width = 8;
+    typedef float Scalar;
+    typedef __m256 Mask;
+    __m256 v;
+
+    static Avx2FloatVec load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Avx2FloatVec broadcast(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+inline Avx2FloatVec operator+(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Avx2FloatVec operator-(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Avx2FloatVec operator*(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Avx2FloatVec operator/(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Avx2FloatVec fmadd(Avx2FloatVec a, Avx2FloatVec b, Avx2FloatVec c) {
+    return {_mm256_fmadd_ps(a.v, b.v, c.v)};
+}
+inline Avx2FloatVec min(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Avx2FloatVec max(Avx2FloatVec a, Avx2FloatVec b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline __m256 lessThan(Avx2FloatVec a, Avx2FloatVec b) {
+    return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+}
+inline Avx2FloatVec select(__m256 mask, Avx2FloatVec a, Avx2FloatVec b) {
+    return {_mm256_blendv_ps(b.v, a.v, mask)};
+}
+inline Avx2FloatVec abs(Avx2FloatVec a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+inline Avx2FloatVec sqrt(Avx2FloatVec a) { return {_mm256_sqrt_ps(a.v)}; }
+inline Avx2FloatVec roundNearest(Avx2FloatVec a) {
+    return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+// Floats convert to 32 bit integers directly, so the exponent field is built from cvtps.
+inline Avx2FloatVec pow2(Avx2FloatVec n) {
+    __m256i bits = _mm256_add_epi32(_mm256_cvtps_epi32(n.v), _mm256_set1_epi32(127));
+    return {_mm256_castsi256_ps(_mm256_slli_epi32(bits, 23))};
+}
+inline Avx2FloatVec exponentOf(Avx2FloatVec a) {
+    __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(a.v), 23);
+    return {_mm256_cvtepi32_ps(_mm256_sub_epi32(bits, _mm256_set1_epi32(127)))};
+}
+inline Avx2FloatVec mantissaOf(Avx2FloatVec a) {
+    __m256i bits = _mm256_and_si256(_mm256_castps_si256(a.v), _mm256_set1_epi32(0x007FFFFF));
+    bits = _mm256_or_si256(bits, _mm256_set1_epi32(0x3F800000));
+    return {_mm256_castsi256_ps(bits)};
+}
+#endif
+
+#if defined(__AVX512F__)
+/**
+ * Eight doubles in an AVX-512 register.
+ */
+struct Avx512Words;
+
+struct Avx512Vec {
+    static constexpr int width = 8;
+    typedef double Scalar;
+    typedef __mmask8 Mask;
+    typedef Avx512Words Words;
+    __m512d v;
+
+    static Avx512Vec load(const double* p) { return {_mm512_loadu_pd(p)}; }
+    static Avx512Vec broadcast(double x) { return {_mm512_set1_pd(x)}; }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+};
+
+inline Avx512Vec operator+(Avx512Vec a, Avx512Vec b) { return {_mm512_add_pd(a.v, b.v)}; }
+inline Avx512Vec operator-(Avx512Vec a, Avx512Vec b) { return {_mm512_sub_pd(a.v, b.v)}; }
+inline Avx512Vec operator*(Avx512Vec a, Avx512Vec b) { return {_mm512_mul_pd(a.v, b.v)}; }
+inline Avx512Vec operator/(Avx512Vec a, Avx512Vec b) { return {_mm512_div_pd(a.v, b.v)}; }
+inline Avx512Vec fmadd(Avx512Vec a, Avx512Vec b, Avx512Vec c) {
+    return {_mm512_fmadd_pd(a.v, b.v, c.v)};
+}
+inline Avx512Vec min(Avx512Vec a, Avx512Vec b) { return {_mm512_min_pd(a.v, b.v)}; }
+inline Avx512Vec max(Avx512Vec a, Avx512Vec b) { return {_mm512_max_pd(a.v, b.v)}; }
+inline __mmask8 lessThan(Avx512Vec a, Avx512Vec b) {
+    return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ);
+}
+inline Avx512Vec select(__mmask8 mask, Avx512Vec a, Avx512Vec b) {
+    return {_mm512_mask_blend_pd(mask, b.v, a.v)};
+}
+inline Avx512Vec abs(Avx512Vec a) { return {_mm512_abs_pd(a.v)}; }
+inline Avx512Vec sqrt(Avx512Vec a) { return {_mm512_sqrt_pd(a.v)}; }
+inline Avx512Vec roundNearest(Avx512Vec a) {
+    return {_mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline Avx512Vec pow2(Avx512Vec n) {
+    __m512i bits = _mm512_castpd_si512(_mm512_add_pd(n.v, _mm512_set1_pd(6755399441055744.0)));
+    bits = _mm512_slli_epi64(_mm512_add_epi64(bits, _mm512_set1_epi64(1023)), 52);
+    return {_mm512_castsi512_pd(bits)};
+}
+inline Avx512Vec exponentOf(Avx512Vec a) {
+    __m512i bits = _mm512_srli_epi64(_mm512_castpd_si512(a.v), 52);
+    bits = _mm512_or_si512(bits, _mm512_set1_epi64(0x4330000000000000ll));
+    return {_mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(4503599627371519.0))};
+}
+inline Avx512Vec mantissaOf(Avx512Vec a) {
+    __m512i bits = _mm512_and_si512(_mm512_castpd_si512(a.v),
+                                    _mm512_set1_epi64(0x000FFFFFFFFFFFFFll));
+    bits = _mm512_or_si512(bits, _mm512_set1_epi64(0x3FF0000000000000ll));
+    return {_mm512_castsi512_pd(bits)};
+}
+/**
+ * Eight 32 bit words in the 64 bit lanes of an AVX-512 register.
+ */
+struct Avx512Words {
+    __m512i v;
+
+    static Avx512Words broadcast(std::uint64_t x) {
+        return {_mm512_set1_epi64(static_cast<long long>(x))};
+    }
+    static Avx512Words iota(std::uint64_t first) {
+        return {_mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(first)),
+                                 _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7))};
+    }
+};
+
+inline Avx512Words operator^(Avx512Words a, Avx512Words b) {
+    return {_mm512_xor_si512(a.v, b.v)};
+}
+inline Avx512Words low32(Avx512Words a) {
+    return {_mm512_and_si512(a.v, _mm512_set1_epi64(0xFFFFFFFFll))};
+}
+inline Avx512Words high32(Avx512Words a) { return {_mm512_srli_epi64(a.v, 32)}; }
+inline Avx512Words mulWide(Avx512Words a, Avx512Words b) { return {_mm512_mul_epu32(a.v, b.v)}; }
+inline Avx512Vec uniformOf(Avx512Words a) {
+    __m512i bits = _mm512_or_si512(a.v, _mm512_set1_epi64(0x4330000000000000ll));
+    __m512d word = _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(4503599627370496.0));
+    return {_mm512_mul_pd(_mm512_add_pd(word, _mm512_set1_pd(0.5)),
+                          _mm512_set1_pd(2.3283064365386963e-10))};
+}
+
+/**
+ * Sixteen floats in an AVX-512 register.
+ */
+struct Avx512FloatVec {
+    static constexpr int width = 16;
+    typedef float Scalar;
+    typedef __mmask16 Mask;
+    __m512 v;
+
+    static Avx512FloatVec load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    static Avx512FloatVec broadcast(float x) { return {_mm512_set1_ps(x)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+};
+
+inline Avx512FloatVec operator+(Avx512FloatVec a, Avx512FloatVec b) {
+    return {_mm512_add_ps(a.v, b.v)};
+}
+inline Avx512FloatVec operator-(Avx512FloatVec a, Avx512FloatVec b) {
+    return {_mm512_sub_ps(a.v, b.v)};
+}
+inline Avx512FloatVec operator*(Avx512FloatVec a, Avx512FloatVec b) {
+    return {_mm512_mul_ps(a.v, b.v)};
+}
+inline Avx512FloatVec operator/(Avx512FloatVec a, Avx512FloatVec b) {
+    return {_mm512_div_ps(a.v, b.v)};
+}
+inline Avx512FloatVec fmadd(Avx512FloatVec a, Avx512FloatVec b, Avx512FloatVec c) {
+    return {_mm512_fmadd_ps(a.v, b.v, c.v)};
+}
+inline Avx512FloatVec min(Avx512FloatVec a, Avx512FloatVec b) { return {_mm512_min_ps(a.v, b.v)}; }
+inline Avx512FloatVec max(Avx512FloatVec a, Avx512FloatVec b) { return {_mm512_max_ps(a.v, b.v)}; }
+inline __mmask16 lessThan(Avx512FloatVec a, Avx512FloatVec b) {
+    return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ);
+}
+inline Avx512FloatVec select(__mmask16 mask, Avx512FloatVec a, Avx512FloatVec b) {
+    return {_mm512_mask_blend_ps(mask, b.v, a.v)};
+}
+inline Avx512FloatVec abs(Avx512FloatVec a) { return {_mm512_abs_ps(a.v)}; }
+inline Avx512FloatVec sqrt(Avx512FloatVec a) { return {_mm512_sqrt_ps(a.v)}; }
+inline Avx512FloatVec roundNearest(Avx512FloatVec a) {
+    return {_mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+inline Avx512FloatVec pow2(Avx512FloatVec n) {
+    __m512i bits = _mm512_add_epi32(_mm512_cvtps_epi32(n.v), _mm512_set1_epi32(127));
+    return {_mm512_castsi512_ps(_mm512_slli_epi32(bits, 23))};
+}
+inline Avx512FloatVec exponentOf(Avx512FloatVec a) {
+    __m512i bits = _mm512_srli_epi32(_mm512_castps_si512(a.v), 23);
+    return {_mm512_cvtepi32_ps(_mm512_sub_epi32(bits, _mm512_set1_epi32(127)))};
+}
+inline Avx512FloatVec mantissaOf(Avx512FloatVec a) {
+    __m512i bits = _mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x007FFFFF));
+    bits = _mm512_or_si512(bits, _mm512_set1_epi32(0x3F800000));
+    return {_mm512_castsi512_ps(bits)};
+}
+#endif
+
+}
+
+#endif //OPTIONSTRACKER_SIMDVEC_H
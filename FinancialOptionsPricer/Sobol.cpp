@@ -0,0 +1,176 @@
+#include "Sobol.h"
+#include <bitset>
+#include <stdexcept>
+#include "Philox.h"
+
+// initial direction numbers m_1 ... m_s of dimensions 2 to 32, from new-joe-kuo-6.21201
+static const std::uint32_t joeKuo[31][7] = {
+        {1}, {1, 3}, {1, 3, 1}, {1, 1, 1}, {1, 1, 3, 3}, {1, 3, 5, 13}, {1, 1, 5, 5, 17},
+        {1, 1, 5, 5, 5}, {1, 1, 7, 11, 19}, {1, 1, 5, 1, 1}, {1, 1, 1, 3, 11}, {1, 3, 5, 5, 31},
+        {1, 3, 3, 9, 7, 49}, {1, 1, 1, 15, 21, 21}, {1, 3, 1, 13, 27, 49}, {1, 1, 1, 15, 7, 5},
+        {1, 3, 1, 15, 13, 25}, {1, 1, 5, 5, 19, 61}, {1, 3, 7, 11, 23, 15, 103},
+        {1, 3, 7, 13, 13, 15, 69}, {1, 1, 3, 13, 7, 35, 63}, {1, 3, 5, 9, 1, 25, 53},
+        {1, 3, 1, 13, 9, 35, 107}, {1, 3, 1, 5, 27, 61, 31}, {1, 1, 5, 11, 19, 41, 61},
+        {1, 3, 5, 3, 3, 13, 69}, {1, 1, 7, 13, 1, 19, 1}, {1, 3, 7, 5, 13, 19, 59},
+        {1, 1, 3, 9, 25, 29, 41}, {1, 3, 5, 13, 23, 1, 55}, {1, 3, 7, 3, 13, 59, 17}};
+
+/**
+ * @return x^power modulo the polynomial over GF(2) of the given degree, polynomials being
+ * bit masks with bit i the coefficient of x^i.
+ */
+static std::uint64_t powerOfX(std::uint64_t power, std::uint64_t polynomial, int degree) {
+    auto multiply = [&](std::uint64_t a, std::uint64_t b) {
+        std::uint64_t product = 0;
+        for (int i = 0; i < degree; i++) {
+            if (b >> i & 1) {
+                product ^= a;
+            }
+            a <<= 1;
+            if (a >> degree & 1) {
+                a ^= polynomial;
+            }
+        }
+        return product;
+    };
+    // x itself, which is 1 modulo x + 1
+    std::uint64_t result = 1, base = degree > 1 ? 2 : 1;
+    for (; power; power >>= 1) {
+        if (power & 1) {
+            result = multiply(result, base);
+        }
+        base = multiply(base, base);
+    }
+    return result;
+}
+
+/**
+ * A polynomial of degree s is primitive when x has order exactly 2^s - 1 modulo it: x^(2^s - 1)
+ * is 1 and x^((2^s - 1) / q) isn't for any prime q dividing 2^s - 1.
+ */
+static bool isPrimitive(std::uint64_t polynomial, int degree) {
+    const std::uint64_t order = (std::uint64_t(1) << degree) - 1;
+    if (powerOfX(order, polynomial, degree) != 1) {
+        return false;
+    }
+    std::uint64_t rest = order;
+    for (std::uint64_t q = 2; q * q <= rest; q++) {
+        if (rest % q == 0) {
+            if (powerOfX(order / q, polynomial, degree) == 1) {
+                return false;
+            }
+            while (rest % q == 0) {
+                rest /= q;
+            }
+        }
+    }
+    return rest == 1 || powerOfX(order / rest, polynomial, degree) != 1;
+}
+
+/**
+ * @return The number of dimensions, checked before the constructor sizes anything with it.
+ * @throws std::invalid_argument If dimensions is not between 1 and Sobol::maxDimensions.
+ */
+static int checkedDimensions(int dimensions) {
+    if (dimensions < 1 || dimensions > Sobol::maxDimensions) {
+        throw std::invalid_argument("Sobol sequences support 1 to 1000 dimensions");
+    }
+    return dimensions;
+}
+
+Sobol::Sobol(int dimensions, std::uint64_t seed)
+        : dimensions(checkedDimensions(dimensions)), directions(32 * dimensions),
+          state(dimensions), index(0) {
+    // the first dimension is the van der Corput sequence, every m_k = 1
+    for (int k = 0; k < 32; k++) {
+        directions[k] = std::uint32_t(1) << (31 - k);
+    }
+
+    const Philox initial(0x536F626F6CULL);
+    int degree = 1;
+    std::uint64_t coefficients = 0;
+    for (int j = 1; j < dimensions; j++) {
+        // next primitive polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1, a in the middle bits
+        while (true) {
+            if (coefficients >= (std::uint64_t(1) << (degree - 1))) {
+                degree++;
+                coefficients = 0;
+            }
+            std::uint64_t polynomial = (std::uint64_t(1) << degree) | coefficients << 1 | 1;
+            coefficients++;
+            if (isPrimitive(polynomial, degree)) {
+                break;
+            }
+        }
+        const std::uint64_t a = coefficients - 1;
+
+        std::uint32_t m[32];
+        for (int k = 0; k < degree && k < 32; k++) {
+            if (j <= 31) {
+                m[k] = joeKuo[j - 1][k];
+            } else {
+                // a random odd number below 2^(k + 1)
+                std::uint32_t bits = initial({static_cast<std::uint32_t>(j),
+                                              static_cast<std::uint32_t>(k), 0, 0})[0];
+                m[k] = (bits & ((std::uint32_t(2) << k) - 1)) | 1;
+            }
+        }
+        for (int k = degree; k < 32; k++) {
+            m[k] = m[k - degree] ^ (m[k - degree] << degree);
+            for (int i = 1; i < degree; i++) {
+                if (a >> (degree - 1 - i) & 1) {
+                    m[k] ^= m[k - i] << i;
+                }
+            }
+        }
+        for (int k = 0; k < 32; k++) {
+            directions[32 * j + k] = m[k] << (31 - k);
+        }
+    }
+
+    // Matousek's scramble: output digit i is digit i of the input plus a random combination of
+    // the more significant digits, a lower triangular matrix with ones on its diagonal
+    const Philox scramble(seed);
+    for (int j = 0; j < dimensions; j++) {
+        std::uint32_t rows[32];
+        for (int i = 0; i < 32; i += 4) {
+            Philox::Block words = scramble({static_cast<std::uint32_t>(j),
+                                            static_cast<std::uint32_t>(i), 1, 0});
+            for (int w = 0; w < 4; w++) {
+                std::uint32_t bit = std::uint32_t(1) << (31 - (i + w));
+                // random bits above the diagonal bit, which is always set
+                rows[i + w] = (words[w] & ~(bit | (bit - 1))) | bit;
+            }
+        }
+        for (int k = 0; k < 32; k++) {
+            std::uint32_t v = directions[32 * j + k], scrambled = 0;
+            for (int i = 0; i < 32; i++) {
+                if (std::bitset<32>(rows[i] & v).count() & 1) {
+                    scrambled |= std::uint32_t(1) << (31 - i);
+                }
+            }
+            directions[32 * j + k] = scrambled;
+        }
+        state[j] = scramble({static_cast<std::uint32_t>(j), 0, 2, 0})[0];
+    }
+}
+
+/**
+ * Point n + 1 is point n with the direction numbers of the lowest zero bit of n xored in, so
+ * the points come in Gray code order, which covers the same first 2^m points as the natural
+ * order. The first point is the random shift itself.
+ */
+void Sobol::next(double* point) {
+    for (int j = 0; j < dimensions; j++) {
+        point[j] = uniformOf(state[j]);
+    }
+    int bit = 0;
+    while (bit < 32 && index >> bit & 1) {
+        bit++;
+    }
+    index++;
+    if (bit < 32) {
+        for (int j = 0; j < dimensions; j++) {
+            state[j] ^= directions[32 * j + bit];
+        }
+    }
+}
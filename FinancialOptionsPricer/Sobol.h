@@ -0,0 +1,49 @@
+#ifndef OPTIONSTRACKER_SOBOL_H
+#define OPTIONSTRACKER_SOBOL_H
+#include <cstdint>
+#include <vector>
+
+/**
+ * Scrambled Sobol sequence, a low discrepancy sequence whose first 2^m points fill the unit
+ * cube far more evenly than random points, so integrals of smooth functions converge close to
+ * O(1/N) rather than O(1/sqrt(N)).
+ *
+ * Dimension j uses the j-th primitive polynomial over GF(2), in order of degree and then of
+ * coefficients, with the initial direction numbers of Joe and Kuo (2008) for the first 32
+ * dimensions and random odd ones, drawn from a fixed seed, beyond them. Points are generated
+ * in Gray code order, one xor per dimension per point.
+ *
+ * The sequence is scrambled with Matousek's random linear scramble and a random digital shift,
+ * drawn from Philox with the given seed: each scramble keeps the low discrepancy while making
+ * every point uniformly distributed, so independent scrambles give independent unbiased
+ * estimates whose spread measures the error. No point is ever exactly 0 or 1.
+ */
+class Sobol {
+private:
+    int dimensions;
+    // direction numbers, 32 per dimension
+    std::vector<std::uint32_t> directions;
+    std::vector<std::uint32_t> state;
+    std::uint32_t index;
+
+public:
+    /**
+     * @param dimensions Number of coordinates of each point.
+     * @param seed Seed of the scramble, one independent randomization per seed.
+     * @throws std::invalid_argument If dimensions is not between 1 and maxDimensions.
+     */
+    Sobol(int dimensions, std::uint64_t seed);
+
+    /**
+     * Largest number of dimensions supported.
+     */
+    static constexpr int maxDimensions = 1000;
+
+    /**
+     * Generates the next point. At most 2^32 points can be generated.
+     *
+     * @param point Receives a uniform number in (0, 1) for each dimension.
+     */
+    void next(double* point);
+};
+#endif //OPTIONSTRACKER_SOBOL_H
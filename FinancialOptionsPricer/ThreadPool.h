@@ -0,0 +1,75 @@
+#ifndef OPTIONSTRACKER_THREADPOOL_H
+#define OPTIONSTRACKER_THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that split loops over many independent items between them.
+ * The threads are started once and reused, so a loop only pays for waking them up. The thread
+ * calling parallelFor works on the loop too and returns when every item is done.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping;
+    long generation;
+    int busyWorkers;
+
+    // the loop being run
+    const std::function<void(std::size_t, std::size_t)>* body;
+    std::size_t count;
+    std::size_t grain;
+    std::atomic<std::size_t> nextItem;
+    std::exception_ptr error;
+
+    /**
+     * Body of each worker thread, waiting for loops and working on them until the pool is
+     * destroyed.
+     */
+    void work();
+
+    /**
+     * Runs chunks of the current loop until none are left.
+     */
+    void runChunks();
+
+public:
+    /**
+     * @param threads Number of threads working on each loop, including the calling thread.
+     *                0 uses one per hardware thread.
+     */
+    explicit ThreadPool(int threads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @return Number of threads working on each loop, including the calling thread.
+     */
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    /**
+     * Runs body over items [0, count) in chunks of grain items, body(begin, end) doing items
+     * [begin, end). Chunks are handed out as threads become free, so uneven work balances
+     * itself. Blocks until every chunk is done, then rethrows the first exception a chunk
+     * threw, if any. Only one thread may call parallelFor on a pool at a time.
+     *
+     * @param count Number of items.
+     * @param grain Number of items per chunk, at least 1.
+     * @param body Function doing one chunk of items.
+     */
+    void parallelFor(std::size_t count, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& body);
+};
+#endif //OPTIONSTRACKER_THREADPOOL_H
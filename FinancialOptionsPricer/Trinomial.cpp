@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "Trinomial.h"
+#include "LatticeKernels.h"
+
+/**
+ * Parameterized constructor for Trinomial.
+ * The log stock price moves by spacing = volatility * sqrt(3 * stepSize) or stays level, and the
+ * probabilities match the mean and variance of the log price over a step:
+ * upMv and downMv = ((variance + drift^2) / spacing^2 +- drift / spacing) / 2.
+ *
+ * @param stockPrice Initial price of the underlying stock.
+ * @param volatility Volatility of the underlying stock.
+ * @param strikePrice Strike price of the option.
+ * @param time Time until the option's expiration.
+ * @param intRate Risk-free interest rate.
+ * @param steps Number of steps in the trinomial tree.
+ * @param exerciseStyle European or American exercise.
+ */
+Trinomial::Trinomial(double stockPrice, double volatility, double strikePrice, double time,
+                     double intRate, int steps, ExerciseStyle exerciseStyle)
+        : Option(stockPrice, volatility, strikePrice, time, intRate),
+          exerciseStyle(exerciseStyle), steps(steps) {
+    if (exerciseStyle == ExerciseStyle::Bermudan) {
+        throw std::invalid_argument("Trinomial supports European and American exercise only");
+    }
+
+    stepSize = time / steps;
+    double spacing = volatility * std::sqrt(3 * stepSize);
+    double drift = (intRate - volatility * volatility / 2) * stepSize;
+    double variance = volatility * volatility * stepSize;
+    double spread = (variance + drift * drift) / (spacing * spacing);
+
+    upMv = (spread + drift / spacing) / 2;
+    downMv = (spread - drift / spacing) / 2;
+    middleMv = 1 - upMv - downMv;
+    discount = std::exp(-intRate * stepSize);
+
+    values.assign(2 * steps + 1, 0.0);
+    stockPrices.resize(2 * steps + 1);
+    double upSz = std::exp(spacing);
+    double price = stockPrice * std::exp(-steps * spacing);
+    for (int i = 0; i <= 2 * steps; i++) {
+        stockPrices[i] = price;
+        price *= upSz;
+    }
+}
+
+/**
+ * Computes the price of a call option.
+ *
+ * @return The calculated price of the call option.
+ */
+double Trinomial::callOptionPrice() {
+    return backwardInduction(1.0);
+}
+
+/**
+ * Computes the price of a put option.
+ *
+ * @return The calculated price of the put option.
+ */
+double Trinomial::putOptionPrice() {
+    return backwardInduction(-1.0);
+}
+
+/**
+ * Fills the rolling array with the payouts at expiration and works it back one level at a time
+ * with the vectorized kernels. An American option keeps the larger of holding and exercising at
+ * every node, reading the stock prices of level n from the terminal prices at offset steps - n.
+ *
+ * @param sign 1 for a call, -1 for a put.
+ * @return The value of the option at the root of the lattice.
+ */
+double Trinomial::backwardInduction(double sign) {
+    double upWeight = discount * upMv;
+    double middleWeight = discount * middleMv;
+    double downWeight = discount * downMv;
+    double* value = values.data();
+
+    for (int i = 0; i <= 2 * steps; i++) {
+        value[i] = std::max(sign * (stockPrices[i] - strikePrice), 0.0);
+    }
+
+    for (int level = steps - 1; level >= 0; level--) {
+        if (exerciseStyle == ExerciseStyle::American) {
+            rollbackTrinomialExerciseLevel(value, stockPrices.data() + steps - level,
+                                           2 * level + 1, strikePrice, sign, upWeight,
+                                           middleWeight, downWeight);
+        }
+        else {
+            rollbackTrinomialLevel(value, 2 * level + 1, upWeight, middleWeight, downWeight);
+        }
+    }
+    return value[0];
+}
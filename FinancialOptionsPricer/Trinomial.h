@@ -0,0 +1,79 @@
+#ifndef OPTIONSTRACKER_TRINOMIAL_H
+#define OPTIONSTRACKER_TRINOMIAL_H
+
+#include <vector>
+#include "Option.h"
+
+/**
+ * Trinomial option pricing model class that inherits from the Option base class.
+ * Over each step the stock price moves up, stays level or moves down, with the log price
+ * spacing chosen as volatility * sqrt(3 * stepSize). The extra branch matches the variance of
+ * the stock price more closely per node than a binomial lattice, and the level middle branch
+ * makes it easier to line nodes up with barriers and dividend dates.
+ */
+class Trinomial: public Option {
+private:
+    /**
+     * Rolling array holding the option values of one level of the recombining lattice.
+     * Level n has 2n + 1 nodes, node i being the price after i - n net upward moves, so a
+     * single array of 2 * steps + 1 values is reused for every level.
+     */
+    std::vector<double> values;
+
+    /**
+     * Stock prices of the terminal nodes. Node i of level n has the same price as terminal node
+     * i + steps - n, so every level reads its stock prices from this array at an offset.
+     */
+    std::vector<double> stockPrices;
+
+    ExerciseStyle exerciseStyle; // European or American exercise.
+
+    int steps;         // Number of time steps in the trinomial tree.
+    double stepSize;   // Size of each step in terms of time.
+    double upMv;       // Upward move probability.
+    double middleMv;   // Probability of staying level.
+    double downMv;     // Downward move probability.
+    double discount;   // Discount factor applied over a single step.
+
+    /**
+     * Rolls the lattice back from the payouts at expiration to the present.
+     *
+     * @param sign 1 for a call, -1 for a put.
+     * @return The value at the root node.
+     */
+    double backwardInduction(double sign);
+
+public:
+    using Option::Option;
+
+    /**
+     * Constructor that initializes the option and the trinomial lattice.
+     *
+     * @param stockPrice Initial stock price.
+     * @param volatility Stock price volatility.
+     * @param strikePrice Option strike price.
+     * @param time Option time to expiration.
+     * @param intRate Risk-free interest rate.
+     * @param steps Number of time steps in the trinomial tree.
+     * @param exerciseStyle European or American exercise.
+     * @throws std::invalid_argument For Bermudan exercise, which is not supported.
+     */
+    Trinomial(double stockPrice, double volatility, double strikePrice, double time,
+              double intRate, int steps, ExerciseStyle exerciseStyle = ExerciseStyle::European);
+
+    /**
+     * Calculate the price of a call option using the trinomial model.
+     *
+     * @return The price of the call option.
+     */
+    double callOptionPrice() override;
+
+    /**
+     * Calculate the price of a put option using the trinomial model.
+     *
+     * @return The price of the put option.
+     */
+    double putOptionPrice() override;
+};
+
+#endif //OPTIONSTRACKER_TRINOMIAL_H
@@ -0,0 +1,486 @@
+#include "VolatilitySurface.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include "ImpliedVolatility.h"
+#include "ThreadPool.h"
+
+// Log moneyness points the arbitrage checks look at across the quoted strikes.
+static constexpr int arbitrageCheckPoints = 201;
+
+/**
+ * Solution of the inner problem of the SVI fit for one m and sigma.
+ */
+struct SviInnerFit {
+    double a;
+    double d;
+    double c;
+    double squaredError;
+};
+
+/**
+ * Solves the n by n linear system matrix * x = rhs, n at most 3, by Gaussian elimination with
+ * partial pivoting.
+ *
+ * @return Whether the matrix was far enough from singular to solve.
+ */
+static bool solveSmallSystem(double matrix[3][3], double rhs[3], int n, double x[3]) {
+    for (int column = 0; column < n; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < n; row++) {
+            if (std::fabs(matrix[row][column]) > std::fabs(matrix[pivot][column])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(matrix[pivot][column]) < 1e-300) {
+            return false;
+        }
+        std::swap(matrix[pivot], matrix[column]);
+        std::swap(rhs[pivot], rhs[column]);
+        for (int row = column + 1; row < n; row++) {
+            double factor = matrix[row][column] / matrix[column][column];
+            for (int k = column; k < n; k++) {
+                matrix[row][k] -= factor * matrix[column][k];
+            }
+            rhs[row] -= factor * rhs[column];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--) {
+        double sum = rhs[row];
+        for (int k = row + 1; k < n; k++) {
+            sum -= matrix[row][k] * x[k];
+        }
+        x[row] = sum / matrix[row][row];
+    }
+    return true;
+}
+
+/**
+ * Least squares fit of the total variances w to a constant plus multiples of up to two features
+ * of each quote.
+ *
+ * @param featureCount Number of features used besides the constant, 1 or 2.
+ * @param coefficients Receives the constant followed by the multiple of each feature.
+ * @return Whether the normal equations could be solved.
+ */
+static bool leastSquares(const std::vector<double>& firstFeature,
+                         const std::vector<double>& secondFeature, const std::vector<double>& w,
+                         int featureCount, double coefficients[3]) {
+    double matrix[3][3] = {};
+    double rhs[3] = {};
+    for (std::size_t i = 0; i < w.size(); i++) {
+        double row[3] = {1.0, firstFeature[i], secondFeature[i]};
+        for (int r = 0; r <= featureCount; r++) {
+            for (int c = 0; c <= featureCount; c++) {
+                matrix[r][c] += row[r] * row[c];
+            }
+            rhs[r] += row[r] * w[i];
+        }
+    }
+    return solveSmallSystem(matrix, rhs, featureCount + 1, coefficients);
+}
+
+/**
+ * Quasi-explicit inner problem of the SVI fit. With y = (k - m) / sigma the total variance is
+ * a + d y + c sqrt(y^2 + 1), linear in a, d = b rho sigma and c = b sigma. Fits them by least
+ * squares under c >= 0, |d| <= c and a non-negative minimum a + sqrt(c^2 - d^2), trying the
+ * unconstrained solution first and then the edges of the constraints: the minimum at zero when
+ * the unconstrained minimum is below it, |d| = c and c = 0.
+ */
+static SviInnerFit fitSviInner(const std::vector<double>& k, const std::vector<double>& w,
+                               double m, double sigma) {
+    std::size_t n = w.size();
+    std::vector<double> y(n), z(n), rising(n), falling(n), none(n, 0.0);
+    for (std::size_t i = 0; i < n; i++) {
+        y[i] = (k[i] - m) / sigma;
+        z[i] = std::sqrt(y[i] * y[i] + 1);
+        rising[i] = z[i] + y[i];
+        falling[i] = z[i] - y[i];
+    }
+    auto squaredError = [&](double a, double d, double c) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            double residual = a + d * y[i] + c * z[i] - w[i];
+            sum += residual * residual;
+        }
+        return sum;
+    };
+
+    SviInnerFit best = {0, 0, 0, std::numeric_limits<double>::infinity()};
+    auto consider = [&](double a, double d, double c) {
+        if (!(c >= 0) || std::fabs(d) > c * (1 + 1e-12) ||
+            a + std::sqrt(std::max(c * c - d * d, 0.0)) < 0) {
+            return;
+        }
+        double error = squaredError(a, d, c);
+        if (error < best.squaredError) {
+            best = {a, d, c, error};
+        }
+    };
+
+    double x[3];
+    bool belowZero = false;
+    if (leastSquares(y, z, w, 2, x)) {
+        consider(x[0], x[1], x[2]);
+        belowZero = x[2] >= std::fabs(x[1]) &&
+                    x[0] + std::sqrt(x[2] * x[2] - x[1] * x[1]) < 0;
+    }
+    // minimum at zero, a = -sqrt(c^2 - d^2): with d = c rho the variance is
+    // c (rho y + z - sqrt(1 - rho^2)), a multiple of a single feature for each rho, so rho is
+    // scanned and the best point refined by golden section search
+    if (belowZero) {
+        auto edgeError = [&](double rho) {
+            double product = 0, square = 0;
+            for (std::size_t i = 0; i < n; i++) {
+                double feature = rho * y[i] + z[i] - std::sqrt(1 - rho * rho);
+                product += feature * w[i];
+                square += feature * feature;
+            }
+            double c = square > 0 ? std::max(product / square, 0.0) : 0.0;
+            double d = c * rho;
+            double a = -std::sqrt(std::max(c * c - d * d, 0.0));
+            consider(a, d, c);
+            return squaredError(a, d, c);
+        };
+        const int scanPoints = 20;
+        int bestPoint = 0;
+        double bestError = std::numeric_limits<double>::infinity();
+        for (int i = 0; i <= scanPoints; i++) {
+            double error = edgeError(-1 + 2.0 * i / scanPoints);
+            if (error < bestError) {
+                bestError = error;
+                bestPoint = i;
+            }
+        }
+        const double ratio = (std::sqrt(5.0) - 1) / 2;
+        double low = -1 + 2.0 * std::max(bestPoint - 1, 0) / scanPoints;
+        double high = -1 + 2.0 * std::min(bestPoint + 1, scanPoints) / scanPoints;
+        double left = high - ratio * (high - low), right = low + ratio * (high - low);
+        double leftError = edgeError(left), rightError = edgeError(right);
+        for (int iteration = 0; iteration < 40; iteration++) {
+            if (leftError < rightError) {
+                high = right;
+                right = left;
+                rightError = leftError;
+                left = high - ratio * (high - low);
+                leftError = edgeError(left);
+            } else {
+                low = left;
+                left = right;
+                leftError = rightError;
+                right = low + ratio * (high - low);
+                rightError = edgeError(right);
+            }
+        }
+    }
+    // rho = 1 and rho = -1
+    if (leastSquares(rising, none, w, 1, x)) {
+        consider(x[0], x[1], x[1]);
+    }
+    if (leastSquares(falling, none, w, 1, x)) {
+        consider(x[0], -x[1], x[1]);
+    }
+    // b = 0, a flat slice
+    consider(std::accumulate(w.begin(), w.end(), 0.0) / n, 0, 0);
+    return best;
+}
+
+/**
+ * Fits an SVI slice to the log moneyness and total variance of the quotes of one expiry,
+ * searching m and ln(sigma) with Nelder-Mead from a few starting widths.
+ */
+static SviSlice fitSviSlice(const std::vector<double>& k, const std::vector<double>& w,
+                            double time) {
+    const double lowestSigma = 1e-4, highestSigma = 10;
+    auto objective = [&](const double point[2]) {
+        double sigma = std::exp(std::min(std::max(point[1], std::log(lowestSigma)),
+                                         std::log(highestSigma)));
+        return fitSviInner(k, w, point[0], sigma).squaredError;
+    };
+
+    std::size_t lowest = std::min_element(w.begin(), w.end()) - w.begin();
+    double span = *std::max_element(k.begin(), k.end()) - *std::min_element(k.begin(), k.end());
+    double bestPoint[2] = {k[lowest], std::log(0.1)};
+    double bestValue = std::numeric_limits<double>::infinity();
+
+    for (double startSigma : {0.05, 0.2, 0.8}) {
+        double simplex[3][2] = {{k[lowest], std::log(startSigma)},
+                                {k[lowest] + 0.25 * span + 0.01, std::log(startSigma)},
+                                {k[lowest], std::log(startSigma) + 1}};
+        double values[3];
+        for (int i = 0; i < 3; i++) {
+            values[i] = objective(simplex[i]);
+        }
+        for (int iteration = 0; iteration < 300; iteration++) {
+            int order[3] = {0, 1, 2};
+            std::sort(order, order + 3, [&](int a, int b) { return values[a] < values[b]; });
+            int best = order[0], middle = order[1], worst = order[2];
+            double size = std::fabs(simplex[worst][0] - simplex[best][0]) +
+                          std::fabs(simplex[worst][1] - simplex[best][1]) +
+                          std::fabs(simplex[middle][0] - simplex[best][0]) +
+                          std::fabs(simplex[middle][1] - simplex[best][1]);
+            if (size < 1e-9) {
+                break;
+            }
+
+            double centroid[2], reflected[2];
+            for (int c = 0; c < 2; c++) {
+                centroid[c] = 0.5 * (simplex[best][c] + simplex[middle][c]);
+                reflected[c] = 2 * centroid[c] - simplex[worst][c];
+            }
+            double reflectedValue = objective(reflected);
+            if (reflectedValue < values[best]) {
+                double expanded[2];
+                for (int c = 0; c < 2; c++) {
+                    expanded[c] = 3 * centroid[c] - 2 * simplex[worst][c];
+                }
+                double expandedValue = objective(expanded);
+                bool expand = expandedValue < reflectedValue;
+                for (int c = 0; c < 2; c++) {
+                    simplex[worst][c] = expand ? expanded[c] : reflected[c];
+                }
+                values[worst] = expand ? expandedValue : reflectedValue;
+            } else if (reflectedValue < values[middle]) {
+                simplex[worst][0] = reflected[0];
+                simplex[worst][1] = reflected[1];
+                values[worst] = reflectedValue;
+            } else {
+                double contracted[2];
+                for (int c = 0; c < 2; c++) {
+                    contracted[c] = 0.5 * (centroid[c] + simplex[worst][c]);
+                }
+                double contractedValue = objective(contracted);
+                if (contractedValue < values[worst]) {
+                    simplex[worst][0] = contracted[0];
+                    simplex[worst][1] = contracted[1];
+                    values[worst] = contractedValue;
+                } else {
+                    for (int i : {middle, worst}) {
+                        for (int c = 0; c < 2; c++) {
+                            simplex[i][c] = 0.5 * (simplex[i][c] + simplex[best][c]);
+                        }
+                        values[i] = objective(simplex[i]);
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            if (values[i] < bestValue) {
+                bestValue = values[i];
+                bestPoint[0] = simplex[i][0];
+                bestPoint[1] = simplex[i][1];
+            }
+        }
+    }
+
+    double sigma = std::exp(std::min(std::max(bestPoint[1], std::log(lowestSigma)),
+                                     std::log(highestSigma)));
+    SviInnerFit inner = fitSviInner(k, w, bestPoint[0], sigma);
+    SviSlice slice{};
+    slice.time = time;
+    slice.a = inner.a;
+    slice.b = inner.c / sigma;
+    slice.rho = inner.c > 0 ? inner.d / inner.c : 0;
+    slice.m = bestPoint[0];
+    slice.sigma = sigma;
+    slice.quotes = static_cast<int>(w.size());
+    double sum = 0;
+    for (std::size_t i = 0; i < w.size(); i++) {
+        double error = slice.volatility(k[i]) - std::sqrt(w[i] / time);
+        sum += error * error;
+    }
+    slice.rmsError = std::sqrt(sum / w.size());
+    return slice;
+}
+
+VolatilitySurface::VolatilitySurface(double stockPrice, double intRate,
+                                     const std::vector<double>& strikePrices,
+                                     const std::vector<double>& times,
+                                     const std::vector<double>& prices,
+                                     const std::vector<OptionType>& types, ThreadPool* pool,
+                                     int strikePoints)
+        : stockPrice(stockPrice), intRate(intRate), firstLogStrike(0), logStrikeStep(1),
+          inverseLogStrikeStep(1), strikePoints(strikePoints), bucketScale(0) {
+    std::size_t count = strikePrices.size();
+    if (times.size() != count || prices.size() != count || types.size() != count) {
+        throw std::invalid_argument("Every quote needs a strike, time, price and type");
+    }
+    if (strikePoints < 2) {
+        throw std::invalid_argument("The volatility grid needs at least two strikes");
+    }
+
+    std::vector<double> stockPrices(count, stockPrice), intRates(count, intRate);
+    std::vector<ImpliedVolatility> implied(count);
+    if (pool != nullptr) {
+        impliedVolatilities(prices.data(), stockPrices.data(), strikePrices.data(), times.data(),
+                            intRates.data(), types.data(), count, implied.data(), *pool);
+    } else {
+        impliedVolatilities(prices.data(), stockPrices.data(), strikePrices.data(), times.data(),
+                            intRates.data(), types.data(), count, implied.data());
+    }
+
+    // group the usable quotes by expiry
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < count; i++) {
+        if (implied[i].status == ImpliedVolatilityStatus::Converged) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return times[a] < times[b];
+    });
+    struct Expiry {
+        double time;
+        std::vector<double> k;
+        std::vector<double> w;
+    };
+    std::vector<Expiry> expiries;
+    double lowestStrike = std::numeric_limits<double>::infinity(), highestStrike = 0;
+    for (std::size_t begin = 0, end; begin < order.size(); begin = end) {
+        double time = times[order[begin]];
+        for (end = begin; end < order.size() && times[order[end]] == time; end++) {
+        }
+        if (end - begin < 5) {
+            continue;
+        }
+        Expiry expiry{time, {}, {}};
+        double forward = stockPrice * std::exp(intRate * time);
+        for (std::size_t i = begin; i < end; i++) {
+            std::size_t quote = order[i];
+            double volatility = implied[quote].volatility;
+            expiry.k.push_back(std::log(strikePrices[quote] / forward));
+            expiry.w.push_back(volatility * volatility * time);
+            lowestStrike = std::min(lowestStrike, strikePrices[quote]);
+            highestStrike = std::max(highestStrike, strikePrices[quote]);
+        }
+        expiries.push_back(std::move(expiry));
+    }
+    if (expiries.empty()) {
+        throw std::invalid_argument("No expiry has the five usable quotes an SVI slice needs");
+    }
+
+    slices.resize(expiries.size());
+    auto fit = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            slices[i] = fitSviSlice(expiries[i].k, expiries[i].w, expiries[i].time);
+        }
+    };
+    if (pool != nullptr) {
+        pool->parallelFor(expiries.size(), 1, fit);
+    } else {
+        fit(0, expiries.size());
+    }
+
+    double lowestK = std::numeric_limits<double>::infinity();
+    double highestK = -std::numeric_limits<double>::infinity();
+    for (const Expiry& expiry : expiries) {
+        lowestK = std::min(lowestK, *std::min_element(expiry.k.begin(), expiry.k.end()));
+        highestK = std::max(highestK, *std::max_element(expiry.k.begin(), expiry.k.end()));
+    }
+    checkArbitrage(lowestK, highestK);
+    fillGrid(lowestStrike, highestStrike);
+}
+
+void VolatilitySurface::checkArbitrage(double lowest, double highest) {
+    double step = (highest - lowest) / (arbitrageCheckPoints - 1);
+    for (std::size_t s = 0; s < slices.size(); s++) {
+        const SviSlice& slice = slices[s];
+        ArbitrageViolation butterfly{ArbitrageKind::Butterfly, slice.time, 0, 0};
+        ArbitrageViolation calendar{ArbitrageKind::Calendar, slice.time, 0, 0};
+        for (int i = 0; i < arbitrageCheckPoints; i++) {
+            double k = lowest + i * step;
+            double shifted = k - slice.m;
+            double root = std::sqrt(shifted * shifted + slice.sigma * slice.sigma);
+            double w = slice.totalVariance(k);
+            double slope = slice.b * (slice.rho + shifted / root);
+            double curvature = slice.b * slice.sigma * slice.sigma / (root * root * root);
+            // density of the terminal stock price, up to a positive factor
+            double tilt = 1 - k * slope / (2 * w);
+            double density = tilt * tilt - 0.25 * slope * slope * (1 / w + 0.25) + 0.5 * curvature;
+            if (density < butterfly.amount) {
+                butterfly.logMoneyness = k;
+                butterfly.amount = density;
+            }
+            if (s > 0) {
+                double drop = w - slices[s - 1].totalVariance(k);
+                if (drop < calendar.amount) {
+                    calendar.logMoneyness = k;
+                    calendar.amount = drop;
+                }
+            }
+        }
+        if (butterfly.amount < 0) {
+            violations.push_back(butterfly);
+        }
+        if (calendar.amount < 0) {
+            violations.push_back(calendar);
+        }
+    }
+}
+
+double VolatilitySurface::totalVariance(double k, double time) const {
+    if (time <= slices.front().time) {
+        return slices.front().totalVariance(k) * time / slices.front().time;
+    }
+    if (time >= slices.back().time) {
+        return slices.back().totalVariance(k) * time / slices.back().time;
+    }
+    auto later = std::upper_bound(slices.begin(), slices.end(), time,
+                                  [](double t, const SviSlice& slice) { return t < slice.time; });
+    auto earlier = later - 1;
+    double weight = (time - earlier->time) / (later->time - earlier->time);
+    return (1 - weight) * earlier->totalVariance(k) + weight * later->totalVariance(k);
+}
+
+double VolatilitySurface::sliceVolatility(double strikePrice, double time) const {
+    time = std::max(time, std::numeric_limits<double>::min());
+    double forward = stockPrice * std::exp(intRate * time);
+    return std::sqrt(totalVariance(std::log(strikePrice / forward), time) / time);
+}
+
+void VolatilitySurface::fillGrid(double lowestStrike, double highestStrike) {
+    // between two expiries a row is read up to the interest over the gap away from the
+    // query's log strike, so the rows reach that far beyond the quoted strikes
+    double drift = std::fabs(intRate) * (slices.back().time - slices.front().time);
+    firstLogStrike = std::log(lowestStrike) - drift;
+    logStrikeStep = (std::log(highestStrike) + drift - firstLogStrike) / (strikePoints - 1);
+    // a single strike leaves the grid constant along the strikes
+    logStrikeStep = logStrikeStep > 0 ? logStrikeStep : 1;
+    inverseLogStrikeStep = 1 / logStrikeStep;
+
+    // a single expiry gets a second row with the same volatilities
+    for (const SviSlice& slice : slices) {
+        rowTimes.push_back(slice.time);
+    }
+    if (rowTimes.size() == 1) {
+        rowTimes.push_back(2 * rowTimes[0]);
+    }
+    double closest = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i + 1 < rowTimes.size(); i++) {
+        rowInverseGaps.push_back(1 / (rowTimes[i + 1] - rowTimes[i]));
+        closest = std::min(closest, rowTimes[i + 1] - rowTimes[i]);
+    }
+    rowInverseGaps.push_back(0);
+
+    grid.resize(rowTimes.size() * strikePoints);
+    for (std::size_t i = 0; i < rowTimes.size(); i++) {
+        double forward = stockPrice * std::exp(intRate * rowTimes[i]);
+        for (int j = 0; j < strikePoints; j++) {
+            double k = firstLogStrike + j * logStrikeStep - std::log(forward);
+            grid[i * strikePoints + j] = totalVariance(k, rowTimes[i]);
+        }
+    }
+
+    double span = rowTimes.back() - rowTimes.front();
+    std::size_t buckets = static_cast<std::size_t>(std::min(std::ceil(span / closest), 1e6)) + 1;
+    bucketScale = buckets / span;
+    std::size_t row = 0;
+    for (std::size_t bucket = 0; bucket < buckets; bucket++) {
+        double start = rowTimes.front() + bucket / bucketScale;
+        while (row + 2 < rowTimes.size() && rowTimes[row + 1] <= start) {
+            row++;
+        }
+        bucketRows.push_back(static_cast<int>(row));
+    }
+}
@@ -0,0 +1,203 @@
+#ifndef OPTIONSTRACKER_VOLATILITYSURFACE_H
+#define OPTIONSTRACKER_VOLATILITYSURFACE_H
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Option.h"
+
+class ThreadPool;
+
+/**
+ * Gatheral's raw SVI parameterization of one expiry: the total implied variance vol^2 * T at
+ * log moneyness k = ln(K / F) is w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2)).
+ */
+struct SviSlice {
+    double time;
+    double a;
+    double b;
+    double rho;
+    double m;
+    double sigma;
+    // root mean square difference between the fitted and the quoted implied volatilities
+    double rmsError;
+    // number of quotes the slice was fitted to
+    int quotes;
+
+    /**
+     * @param k Log moneyness ln(K / F).
+     * @return Total implied variance at k.
+     */
+    double totalVariance(double k) const {
+        double shifted = k - m;
+        return a + b * (rho * shifted + std::sqrt(shifted * shifted + sigma * sigma));
+    }
+
+    /**
+     * @param k Log moneyness ln(K / F).
+     * @return Implied volatility at k.
+     */
+    double volatility(double k) const { return std::sqrt(totalVariance(k) / time); }
+};
+
+/**
+ * Kind of static arbitrage a fitted surface allows.
+ */
+enum class ArbitrageKind {
+    // a slice's call prices are not convex in the strike, a negative probability density
+    Butterfly,
+    // a later slice has less total variance than an earlier one at the same log moneyness
+    Calendar
+};
+
+/**
+ * The worst point of one arbitrage a fitted surface allows.
+ */
+struct ArbitrageViolation {
+    ArbitrageKind kind;
+    // expiry of the slice, the later one for calendar arbitrage
+    double time;
+    // log moneyness of the worst point
+    double logMoneyness;
+    // how far the condition is broken: the negative density g(k) of Gatheral and Jacquier for
+    // butterflies, the drop in total variance for calendars
+    double amount;
+};
+
+/**
+ * Implied volatility surface fitted to a chain of European option quotes on one stock. The
+ * quotes are inverted to implied volatilities, one SVI slice is fitted to each expiry and the
+ * surface between expiries interpolates total variance linearly in time at fixed log
+ * moneyness. The result is sampled once on a dense grid of log strikes at each expiry, so
+ * volatility costs an interpolation of total variance whatever the number of quotes.
+ *
+ * Each slice is fitted with the quasi-explicit method of Zeliade Systems: for a given m and
+ * sigma the total variance is linear in the other three parameters, which a small least squares
+ * problem solves under the constraints b >= 0, |rho| <= 1 and a non-negative minimum, leaving a
+ * two parameter Nelder-Mead search over m and sigma.
+ */
+class VolatilitySurface {
+private:
+    double stockPrice;
+    double intRate;
+    std::vector<SviSlice> slices;
+    std::vector<ArbitrageViolation> violations;
+
+    // dense grid, the total variance at strike exp(firstLogStrike + j * logStrikeStep) and the
+    // time of expiry i at grid[i * strikePoints + j]. Total variance is linear in time between
+    // expiries at fixed log moneyness, so rows at the expiries lose nothing to interpolation in
+    // time as long as each row is read at the query's log moneyness.
+    double firstLogStrike;
+    double logStrikeStep;
+    double inverseLogStrikeStep;
+    int strikePoints;
+    std::vector<double> rowTimes;
+    std::vector<double> rowInverseGaps;
+    std::vector<double> grid;
+
+    // row of the grid at or before the start of each of the equal buckets splitting the first
+    // to the last expiry. The buckets are narrower than the gap between the closest two
+    // expiries, up to a million of them, so the row is at most one past the bucket's.
+    std::vector<int> bucketRows;
+    double bucketScale;
+
+    /**
+     * Total variance of one row of the grid, interpolated linearly in log strike and constant
+     * beyond the first and last strike.
+     */
+    double rowVariance(int row, double logStrike) const {
+        double column = (logStrike - firstLogStrike) * inverseLogStrikeStep;
+        column = std::fmin(std::fmax(column, 0.0), strikePoints - 1.0);
+        int j = std::min(static_cast<int>(column), strikePoints - 2);
+        const double* node = &grid[row * strikePoints + j];
+        return node[0] + (column - j) * (node[1] - node[0]);
+    }
+
+    /**
+     * Looks for butterfly arbitrage in each slice and calendar arbitrage between neighbouring
+     * slices at log moneyness points spanning the quoted strikes.
+     */
+    void checkArbitrage(double lowest, double highest);
+
+    /**
+     * Total variance of the fitted surface at a log moneyness and time between the first and
+     * last expiry.
+     */
+    double totalVariance(double k, double time) const;
+
+    /**
+     * Samples the fitted surface on the dense grid and builds the table of rows by time.
+     */
+    void fillGrid(double lowestStrike, double highestStrike);
+
+public:
+    /**
+     * Fits the surface to a chain of quotes. Quotes with the same time to expiration form a
+     * slice. Quotes whose implied volatility can't be found are left out, and expiries with
+     * fewer than five usable quotes, which can't determine the five SVI parameters, get no
+     * slice.
+     *
+     * @param stockPrice Current price of the stock.
+     * @param intRate Annual risk-free interest rate.
+     * @param strikePrices Strike price of each quote.
+     * @param times Time to expiration of each quote in years.
+     * @param prices Market price of each quote.
+     * @param types Whether each quote is for a call or a put.
+     * @param pool Threads to invert the quotes and fit the slices on, nullptr for the calling
+     *             thread only.
+     * @param strikePoints Number of strikes in the dense grid.
+     * @throws std::invalid_argument If the quote vectors differ in length, the grid has fewer
+     * than two strikes or no expiry has enough usable quotes.
+     */
+    VolatilitySurface(double stockPrice, double intRate, const std::vector<double>& strikePrices,
+                      const std::vector<double>& times, const std::vector<double>& prices,
+                      const std::vector<OptionType>& types, ThreadPool* pool = nullptr,
+                      int strikePoints = 256);
+
+    /**
+     * Implied volatility at a strike and time, interpolated on the dense grid. Strikes and times
+     * outside the quoted ones get the volatility at the nearest edge of the grid. Takes constant
+     * time: the row comes from a table of equal time buckets rather than a search.
+     *
+     * @param strikePrice Strike price of the option.
+     * @param time Time to expiration in years.
+     * @return Implied volatility of the option.
+     */
+    double volatility(double strikePrice, double time) const {
+        time = std::fmin(std::fmax(time, rowTimes.front()), rowTimes.back());
+        int bucket = static_cast<int>((time - rowTimes.front()) * bucketScale);
+        int i = bucketRows[std::min(bucket, static_cast<int>(bucketRows.size()) - 1)];
+        while (i + 2 < static_cast<int>(rowTimes.size()) && time >= rowTimes[i + 1]) {
+            i++;
+        }
+        double y = (time - rowTimes[i]) * rowInverseGaps[i];
+
+        // the strikes with the query's log moneyness at the two expiries
+        double logStrike = std::log(strikePrice);
+        double near = rowVariance(i, logStrike - intRate * (time - rowTimes[i]));
+        double far = rowVariance(i + 1, logStrike + intRate * (rowTimes[i + 1] - time));
+        return std::sqrt((near + y * (far - near)) / time);
+    }
+
+    /**
+     * Implied volatility at a strike and time evaluated from the SVI slices directly, without
+     * the grid. Slower than volatility but exact between grid points.
+     *
+     * @param strikePrice Strike price of the option.
+     * @param time Time to expiration in years.
+     * @return Implied volatility of the option.
+     */
+    double sliceVolatility(double strikePrice, double time) const;
+
+    /**
+     * @return The fitted slice of each expiry with enough quotes, earliest first.
+     */
+    const std::vector<SviSlice>& sviSlices() const { return slices; }
+
+    /**
+     * @return The worst point of each butterfly and calendar arbitrage the fitted slices allow,
+     * empty for an arbitrage free surface.
+     */
+    const std::vector<ArbitrageViolation>& arbitrage() const { return violations; }
+};
+
+#endif //OPTIONSTRACKER_VOLATILITYSURFACE_H
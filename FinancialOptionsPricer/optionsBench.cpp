@@ -0,0 +1,1585 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include "Binomial.h"
+#include "BinomialChain.h"
+#include "BlackScholes.h"
+#include "BlackScholesBatch.h"
+#include "BlackScholesBook.h"
+#include "BlackScholesGrid.h"
+#include "ImpliedVolatility.h"
+#include "MonteCarlo.h"
+#include "NormalDistribution.h"
+#include "PathDependentEngine.h"
+#include "PricingEngines.h"
+#include "QuasiMonteCarlo.h"
+#include "Trinomial.h"
+#include "VolatilitySurface.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+/**
+ * Benchmarks for the pricers. Run with no arguments for every benchmark, or with the names
+ * of the benchmarks to run.
+ */
+
+// keeps the compiler from removing pricing work whose result is otherwise unused
+static volatile double sink;
+
+// number of measured errors above their documented bounds, the exit code is 1 if any
+static int failedChecks = 0;
+
+/**
+ * Compares a measured error with the bound it must stay within, printing and counting it when
+ * it does not so the run ends with a failing exit code.
+ *
+ * @param what Name of the measured quantity.
+ * @param error Measured error.
+ * @param bound Largest error allowed.
+ */
+static void checkBound(const char* what, double error, double bound) {
+    if (!(error <= bound)) {
+        std::printf("FAILED %s: error %.2e above the bound %.2e\n", what, error, bound);
+        failedChecks++;
+    }
+}
+
+/**
+ * Runs a piece of work repeatedly until enough time has passed to time it reliably.
+ *
+ * @param work Function doing one run of the work.
+ * @return Average time of one run in seconds.
+ */
+template<class Work>
+static double secondsPerRun(Work work) {
+    using Clock = std::chrono::steady_clock;
+    const double minimumSeconds = 0.25;
+    long runs = 0;
+    double elapsed = 0;
+    Clock::time_point start = Clock::now();
+
+    do {
+        work();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minimumSeconds);
+    return elapsed / runs;
+}
+
+/**
+ * @return Every instruction set level this machine and build can run, lowest first.
+ */
+static std::vector<SimdLevel> availableSimdLevels() {
+    std::vector<SimdLevel> levels;
+    for (int level = 0; level <= static_cast<int>(detectSimdLevel()); level++) {
+        levels.push_back(static_cast<SimdLevel>(level));
+    }
+    return levels;
+}
+
+/**
+ * Nodes per second of the binomial backward induction for each instruction set level.
+ */
+static void latticeBenchmark() {
+    std::printf("Binomial backward induction, nodes per second\n");
+    std::printf("%-10s %-9s %8s %14s %12s\n", "isa", "exercise", "steps", "nodes/s", "ms/price");
+
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        for (ExerciseStyle style : {ExerciseStyle::European, ExerciseStyle::American}) {
+            for (int steps : {1000, 5000, 10000}) {
+                Binomial binomial(100, 0.2, 100, 1, 0.05, steps, style);
+                double seconds = secondsPerRun([&] { sink = binomial.putOptionPrice(); });
+                double nodes = 0.5 * steps * (steps + 1.0);
+                std::printf("%-10s %-9s %8d %14.3e %12.3f\n", simdLevelName(level),
+                            style == ExerciseStyle::European ? "European" : "American", steps,
+                            nodes / seconds, seconds * 1e3);
+            }
+        }
+    }
+    setSimdLevel(detectSimdLevel());
+    std::printf("\n");
+}
+
+/**
+ * A 200 strike chain priced with one shared lattice against 200 separate Binomial prices.
+ */
+static void chainBenchmark() {
+    const int steps = 2000;
+    std::vector<double> strikes;
+    for (int k = 0; k < 200; k++) {
+        strikes.push_back(60 + 0.4 * k);
+    }
+
+    std::printf("200 strike chain, %d steps, calls and puts\n", steps);
+    std::printf("%-10s %-9s %14s %14s %9s\n", "isa", "exercise", "separate ms", "chain ms",
+                "speedup");
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        for (ExerciseStyle style : {ExerciseStyle::European, ExerciseStyle::American}) {
+            double separate = secondsPerRun([&] {
+                for (double strike : strikes) {
+                    Binomial binomial(100, 0.2, strike, 1, 0.05, steps, style);
+                    sink = binomial.callPutPrice().put;
+                }
+            });
+            double chained = secondsPerRun([&] {
+                BinomialChain chain(100, 0.2, 1, 0.05, steps, style);
+                sink = chain.price(strikes).back().put;
+            });
+            std::printf("%-10s %-9s %14.2f %14.2f %8.2fx\n", simdLevelName(level),
+                        style == ExerciseStyle::European ? "European" : "American",
+                        separate * 1e3, chained * 1e3, separate / chained);
+        }
+    }
+    setSimdLevel(detectSimdLevel());
+    std::printf("\n");
+}
+
+/**
+ * Error against Black-Scholes of each lattice scheme as the number of steps grows, and the
+ * number of steps after which the error stays below a tenth of a cent.
+ */
+static void convergenceBenchmark() {
+    const double stockPrice = 100, volatility = 0.2, strikePrice = 110, time = 1, intRate = 0.05;
+    const double tolerance = 1e-3;
+    struct Scheme {
+        const char* name;
+        LatticeScheme scheme;
+    };
+    const Scheme schemes[] = {
+            {"CRR", LatticeScheme::CoxRossRubinstein},
+            {"JR", LatticeScheme::JarrowRudd},
+            {"Tian", LatticeScheme::Tian},
+            {"LR", LatticeScheme::LeisenReimer},
+    };
+    const int tableSteps[] = {25, 51, 101, 201, 401, 801, 1601};
+
+    BlackScholes blackScholes(stockPrice, volatility, strikePrice, time, intRate);
+    double exact = blackScholes.callOptionPrice();
+    std::printf("European call S=%g K=%g vol=%g T=%g r=%g, Black-Scholes %.6f\n", stockPrice,
+                strikePrice, volatility, time, intRate, exact);
+    std::printf("%-6s", "steps");
+    for (int steps : tableSteps) {
+        std::printf(" %10d", steps);
+    }
+    std::printf(" %12s\n", "steps<1e-3");
+
+    for (const Scheme& scheme : schemes) {
+        std::printf("%-6s", scheme.name);
+        for (int steps : tableSteps) {
+            Binomial binomial(stockPrice, volatility, strikePrice, time, intRate, steps,
+                              ExerciseStyle::European, scheme.scheme);
+            std::printf(" %10.2e", std::fabs(binomial.callOptionPrice() - exact));
+        }
+
+        // last step count of the scan still outside the tolerance
+        int lastMiss = 0;
+        for (int steps = 5; steps <= 3001; steps += 2) {
+            Binomial binomial(stockPrice, volatility, strikePrice, time, intRate, steps,
+                              ExerciseStyle::European, scheme.scheme);
+            if (std::fabs(binomial.callOptionPrice() - exact) >= tolerance) {
+                lastMiss = steps;
+            }
+        }
+        if (lastMiss >= 3001) {
+            std::printf(" %12s\n", "> 3001");
+        }
+        else {
+            std::printf(" %12d\n", lastMiss + 2);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * American put error and time per price of the plain lattice and of BBSR. The reference is a
+ * Leisen-Reimer lattice with 20001 steps.
+ */
+static void smoothingBenchmark() {
+    const double stockPrice = 100, volatility = 0.2, time = 1, intRate = 0.05;
+
+    std::printf("American put, plain CRR lattice against BBSR\n");
+    std::printf("%-7s %6s %12s %12s %12s %12s\n", "strike", "steps", "plain err", "plain us",
+                "BBSR err", "BBSR us");
+    for (double strikePrice : {90.0, 100.0, 110.0}) {
+        Binomial reference(stockPrice, volatility, strikePrice, time, intRate, 20001,
+                           ExerciseStyle::American, LatticeScheme::LeisenReimer);
+        double exact = reference.putOptionPrice();
+
+        for (int steps : {50, 100, 200, 400, 1000}) {
+            Binomial plain(stockPrice, volatility, strikePrice, time, intRate, steps,
+                           ExerciseStyle::American);
+            Binomial smoothed(stockPrice, volatility, strikePrice, time, intRate, steps,
+                              ExerciseStyle::American);
+            smoothed.setBlackScholesSmoothing(true);
+
+            double plainError = std::fabs(plain.putOptionPrice() - exact);
+            double smoothedError = std::fabs(smoothed.putOptionPrice() - exact);
+            double plainSeconds = secondsPerRun([&] { sink = plain.putOptionPrice(); });
+            double smoothedSeconds = secondsPerRun([&] { sink = smoothed.putOptionPrice(); });
+            std::printf("%-7g %6d %12.2e %12.1f %12.2e %12.1f\n", strikePrice, steps, plainError,
+                        plainSeconds * 1e6, smoothedError, smoothedSeconds * 1e6);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Steps and time for the binomial and trinomial lattices to reach a fixed error. The step
+ * counts grow by about 5% at a time, and a lattice reaches the target at the step count after
+ * the last one whose error was above it.
+ */
+static void trinomialBenchmark() {
+    const double stockPrice = 100, volatility = 0.2, strikePrice = 110, time = 1, intRate = 0.05;
+    std::vector<int> scan;
+    for (double steps = 10; steps <= 4000; steps *= 1.05) {
+        scan.push_back(static_cast<int>(steps));
+    }
+
+    BlackScholes blackScholes(stockPrice, volatility, strikePrice, time, intRate);
+    Binomial reference(stockPrice, volatility, strikePrice, time, intRate, 20001,
+                       ExerciseStyle::American, LatticeScheme::LeisenReimer);
+    double exactEuropean = blackScholes.callOptionPrice();
+    double exactAmerican = reference.putOptionPrice();
+
+    std::printf("Time to accuracy, binomial (CRR) against trinomial, K=%g\n", strikePrice);
+    std::printf("%-14s %-10s %8s %8s %12s\n", "option", "lattice", "target", "steps", "us/price");
+    for (ExerciseStyle style : {ExerciseStyle::European, ExerciseStyle::American}) {
+        bool european = style == ExerciseStyle::European;
+        double exact = european ? exactEuropean : exactAmerican;
+        for (double target : {1e-2, 1e-3}) {
+            for (bool trinomial : {false, true}) {
+                // price of the European call or American put with the given number of steps
+                auto price = [&](int steps) {
+                    if (trinomial) {
+                        Trinomial lattice(stockPrice, volatility, strikePrice, time, intRate,
+                                          steps, style);
+                        return european ? lattice.callOptionPrice() : lattice.putOptionPrice();
+                    }
+                    Binomial lattice(stockPrice, volatility, strikePrice, time, intRate, steps,
+                                     style);
+                    return european ? lattice.callOptionPrice() : lattice.putOptionPrice();
+                };
+
+                std::size_t reached = 0;
+                for (std::size_t i = 0; i < scan.size(); i++) {
+                    if (std::fabs(price(scan[i]) - exact) >= target) {
+                        reached = i + 1;
+                    }
+                }
+                const char* option = european ? "European call" : "American put";
+                const char* lattice = trinomial ? "trinomial" : "binomial";
+                if (reached == scan.size()) {
+                    std::printf("%-14s %-10s %8.0e %8s %12s\n", option, lattice, target, "-", "-");
+                    continue;
+                }
+                int steps = scan[reached];
+                double seconds = secondsPerRun([&] { sink = price(steps); });
+                std::printf("%-14s %-10s %8.0e %8d %12.1f\n", option, lattice, target, steps,
+                            seconds * 1e6);
+            }
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Price, delta, gamma and theta from one lattice induction against the four lattices needed to
+ * get them by bumping the stock price and the time.
+ */
+static void greeksBenchmark() {
+    const double stockPrice = 100, volatility = 0.2, strikePrice = 105, time = 1, intRate = 0.05;
+    const double bump = 0.01 * stockPrice;
+
+    std::printf("Lattice Greeks, one induction against bumped lattices, calls and puts\n");
+    std::printf("%-9s %6s %14s %14s %9s\n", "exercise", "steps", "bumped us", "greeks() us",
+                "speedup");
+    for (ExerciseStyle style : {ExerciseStyle::European, ExerciseStyle::American}) {
+        for (int steps : {200, 1000, 4000}) {
+            double stepSize = time / steps;
+            double bumped = secondsPerRun([&] {
+                Binomial base(stockPrice, volatility, strikePrice, time, intRate, steps, style);
+                Binomial up(stockPrice + bump, volatility, strikePrice, time, intRate, steps, style);
+                Binomial down(stockPrice - bump, volatility, strikePrice, time, intRate, steps,
+                              style);
+                Binomial later(stockPrice, volatility, strikePrice, time - stepSize, intRate,
+                               steps - 1, style);
+                sink = base.callPutPrice().put + up.callPutPrice().put +
+                       down.callPutPrice().put + later.callPutPrice().put;
+            });
+            double single = secondsPerRun([&] {
+                Binomial lattice(stockPrice, volatility, strikePrice, time, intRate, steps, style);
+                sink = lattice.greeks().theta.put;
+            });
+            std::printf("%-9s %6d %14.1f %14.1f %8.2fx\n",
+                        style == ExerciseStyle::European ? "European" : "American", steps,
+                        bumped * 1e6, single * 1e6, bumped / single);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Options per second of BlackScholesBatch on a million random calls and puts for each
+ * instruction set level, against one BlackScholes object per option priced through Option.
+ */
+static void blackScholesBenchmark() {
+    const std::size_t count = 1000000;
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    BlackScholesBatch batch;
+    std::vector<BlackScholes> objects;
+    std::vector<OptionType> types;
+    batch.reserve(count);
+    objects.reserve(count);
+    types.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        double stockPrice = 50 + 100 * uniform(generator);
+        double volatility = 0.05 + 0.75 * uniform(generator);
+        double strikePrice = stockPrice * (0.5 + uniform(generator));
+        double time = 0.02 + 3 * uniform(generator);
+        double intRate = 0.08 * uniform(generator);
+        OptionType type = uniform(generator) < 0.5 ? OptionType::Call : OptionType::Put;
+        batch.addOption(stockPrice, volatility, strikePrice, time, intRate, type);
+        objects.emplace_back(stockPrice, volatility, strikePrice, time, intRate);
+        types.push_back(type);
+    }
+
+    std::vector<double> expected(count);
+    double objectSeconds = secondsPerRun([&] {
+        for (std::size_t i = 0; i < count; i++) {
+            Option& option = objects[i];
+            expected[i] = types[i] == OptionType::Call ? option.callOptionPrice()
+                                                       : option.putOptionPrice();
+        }
+    });
+
+    std::printf("Black-Scholes, %zu options, options per second\n", count);
+    std::printf("%-12s %14s %9s %12s\n", "path", "options/s", "speedup", "max error");
+    std::printf("%-12s %14.3e %9s %12s\n", "per object", count / objectSeconds, "1.00x", "-");
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        std::vector<double> prices;
+        double seconds = secondsPerRun([&] { prices = batch.prices(); });
+        double error = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            error = std::max(error, std::fabs(prices[i] - expected[i]));
+        }
+        std::printf("%-12s %14.3e %8.2fx %12.2e\n", simdLevelName(level), count / seconds,
+                    objectSeconds / seconds, error);
+    }
+    setSimdLevel(detectSimdLevel());
+    std::printf("\n");
+}
+
+/**
+ * Cost and error of each NormalAccuracy tier: the normal cdf alone, BlackScholes objects
+ * pricing calls and puts, and BlackScholesBatch with the best instruction set. Errors are
+ * against the Full tier.
+ */
+static void normalBenchmark() {
+    const std::size_t count = 1000000;
+    const NormalAccuracy tiers[] = {NormalAccuracy::Full, NormalAccuracy::High,
+                                    NormalAccuracy::Fast};
+    const char* tierNames[] = {"Full", "High", "Fast"};
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<double> points(count);
+    BlackScholesBatch batch;
+    std::vector<double> stockPrices, volatilities, strikePrices, times, intRates;
+    for (std::size_t i = 0; i < count; i++) {
+        points[i] = -10 + 20 * uniform(generator);
+        stockPrices.push_back(50 + 100 * uniform(generator));
+        volatilities.push_back(0.05 + 0.75 * uniform(generator));
+        strikePrices.push_back(stockPrices[i] * (0.5 + uniform(generator)));
+        times.push_back(0.02 + 3 * uniform(generator));
+        intRates.push_back(0.08 * uniform(generator));
+        batch.addOption(stockPrices[i], volatilities[i], strikePrices[i], times[i], intRates[i],
+                        i % 2 == 0 ? OptionType::Call : OptionType::Put);
+    }
+
+    std::vector<double> exactCdf(count), exactObject(2 * count);
+    std::vector<double> exactBatch = batch.prices();
+    for (std::size_t i = 0; i < count; i++) {
+        exactCdf[i] = normalCdf(points[i]);
+        CallPut price = BlackScholes(stockPrices[i], volatilities[i], strikePrices[i], times[i],
+                                     intRates[i]).callPutPrice();
+        exactObject[2 * i] = price.call;
+        exactObject[2 * i + 1] = price.put;
+    }
+
+    std::printf("Normal distribution accuracy tiers, %s batch\n", simdLevelName(activeSimdLevel()));
+    std::printf("%-5s %10s %10s %16s %10s %14s %10s\n", "tier", "cdf ns", "cdf error",
+                "object prices/s", "error", "batch prices/s", "error");
+    std::vector<double> cdf(count), object(2 * count);
+    for (int tier = 0; tier < 3; tier++) {
+        NormalAccuracy accuracy = tiers[tier];
+        double cdfSeconds = secondsPerRun([&] {
+            for (std::size_t i = 0; i < count; i++) {
+                cdf[i] = normalCdf(points[i], accuracy);
+            }
+        });
+        double objectSeconds = secondsPerRun([&] {
+            for (std::size_t i = 0; i < count; i++) {
+                CallPut price = BlackScholes(stockPrices[i], volatilities[i], strikePrices[i],
+                                             times[i], intRates[i], accuracy).callPutPrice();
+                object[2 * i] = price.call;
+                object[2 * i + 1] = price.put;
+            }
+        });
+        std::vector<double> prices;
+        double batchSeconds = secondsPerRun([&] { prices = batch.prices(accuracy); });
+
+        double cdfError = 0, objectError = 0, batchError = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            cdfError = std::max(cdfError, std::fabs(cdf[i] - exactCdf[i]));
+            objectError = std::max(objectError, std::fabs(object[2 * i] - exactObject[2 * i]));
+            objectError = std::max(objectError,
+                                   std::fabs(object[2 * i + 1] - exactObject[2 * i + 1]));
+            batchError = std::max(batchError, std::fabs(prices[i] - exactBatch[i]));
+        }
+        std::printf("%-5s %10.2f %10.1e %16.3e %10.1e %14.3e %10.1e\n", tierNames[tier],
+                    cdfSeconds / count * 1e9, cdfError, 2 * count / objectSeconds, objectError,
+                    count / batchSeconds, batchError);
+    }
+    std::printf("\n");
+}
+
+/**
+ * BlackScholes::greeks against the 13 bumped revaluations that central differences need for
+ * the same seven Greeks: two stock bumps for delta and gamma, two volatility bumps for vega
+ * and volga, four cross bumps for vanna and two each for theta and rho.
+ */
+static void analyticGreeksBenchmark() {
+    const double stockPrice = 100, volatility = 0.25, strikePrice = 105, time = 0.75;
+    const double intRate = 0.04, bump = 1e-4;
+
+    std::printf("Black-Scholes Greeks, one evaluation against bumped revaluations\n");
+    std::printf("%-5s %12s %13s %9s\n", "tier", "bumped ns", "greeks() ns", "speedup");
+    const NormalAccuracy tiers[] = {NormalAccuracy::Full, NormalAccuracy::High,
+                                    NormalAccuracy::Fast};
+    const char* tierNames[] = {"Full", "High", "Fast"};
+    for (int tier = 0; tier < 3; tier++) {
+        NormalAccuracy accuracy = tiers[tier];
+        auto price = [&](double stockShift, double volatilityShift, double timeShift,
+                         double rateShift) {
+            return BlackScholes(stockPrice * (1 + stockShift), volatility + volatilityShift,
+                                strikePrice, time + timeShift, intRate + rateShift,
+                                accuracy).callPutPrice().put;
+        };
+        double bumped = secondsPerRun([&] {
+            double total = price(0, 0, 0, 0);
+            for (double sign : {-1.0, 1.0}) {
+                total += price(sign * bump, 0, 0, 0) + price(0, sign * bump, 0, 0) +
+                         price(0, 0, sign * bump, 0) + price(0, 0, 0, sign * bump) +
+                         price(sign * bump, bump, 0, 0) + price(sign * bump, -bump, 0, 0);
+            }
+            sink = total;
+        });
+        double single = secondsPerRun([&] {
+            BlackScholes blackScholes(stockPrice, volatility, strikePrice, time, intRate, accuracy);
+            sink = blackScholes.greeks().vanna.put;
+        });
+        std::printf("%-5s %12.1f %13.1f %8.2fx\n", tierNames[tier], bumped * 1e9, single * 1e9,
+                    bumped / single);
+    }
+    std::printf("\n");
+
+    // every Greek of both sides against central differences of the full accuracy prices, over
+    // strikes in and out of the money and short and long expirations; the differences are taken
+    // over relative steps of 1e-4, and of 1e-3 for gamma and volga
+    const char* greekNames[] = {"delta", "gamma", "vega", "theta", "rho", "vanna", "volga"};
+    double maxErrors[7] = {};
+    for (double strike : {70.0, 95.0, 100.0, 105.0, 140.0}) {
+        for (double expiry : {0.1, 0.75, 3.0}) {
+            auto prices = [&](double stockShift, double volatilityShift, double timeShift,
+                              double rateShift) {
+                return BlackScholes(stockPrice + stockShift, volatility + volatilityShift, strike,
+                                    expiry + timeShift, intRate + rateShift).callPutPrice();
+            };
+            BlackScholesGreeks greeks = BlackScholes(stockPrice, volatility, strike, expiry,
+                                                     intRate).greeks();
+            const double ds = 1e-4 * stockPrice, dv = 1e-4 * volatility, dt = 1e-4 * expiry;
+            const double dr = 1e-4, ds2 = 1e-3 * stockPrice, dv2 = 1e-3 * volatility;
+            CallPut base = prices(0, 0, 0, 0);
+            CallPut upS = prices(ds, 0, 0, 0), downS = prices(-ds, 0, 0, 0);
+            CallPut upS2 = prices(ds2, 0, 0, 0), downS2 = prices(-ds2, 0, 0, 0);
+            CallPut upV = prices(0, dv, 0, 0), downV = prices(0, -dv, 0, 0);
+            CallPut upV2 = prices(0, dv2, 0, 0), downV2 = prices(0, -dv2, 0, 0);
+            CallPut upT = prices(0, 0, dt, 0), downT = prices(0, 0, -dt, 0);
+            CallPut upR = prices(0, 0, 0, dr), downR = prices(0, 0, 0, -dr);
+            CallPut upUp = prices(ds, dv, 0, 0), upDown = prices(ds, -dv, 0, 0);
+            CallPut downUp = prices(-ds, dv, 0, 0), downDown = prices(-ds, -dv, 0, 0);
+
+            for (int side = 0; side < 2; side++) {
+                auto pick = [side](const CallPut& value) {
+                    return side == 0 ? value.call : value.put;
+                };
+                const double analytic[] = {
+                        pick(greeks.delta), pick(greeks.gamma), pick(greeks.vega),
+                        pick(greeks.theta), pick(greeks.rho), pick(greeks.vanna),
+                        pick(greeks.volga)};
+                const double differences[] = {
+                        (pick(upS) - pick(downS)) / (2 * ds),
+                        (pick(upS2) - 2 * pick(base) + pick(downS2)) / (ds2 * ds2),
+                        (pick(upV) - pick(downV)) / (2 * dv),
+                        -(pick(upT) - pick(downT)) / (2 * dt),
+                        (pick(upR) - pick(downR)) / (2 * dr),
+                        (pick(upUp) - pick(upDown) - pick(downUp) + pick(downDown)) /
+                        (4 * ds * dv),
+                        (pick(upV2) - 2 * pick(base) + pick(downV2)) / (dv2 * dv2)};
+                for (int greek = 0; greek < 7; greek++) {
+                    double error = std::fabs(analytic[greek] - differences[greek]) /
+                                   (1 + std::fabs(analytic[greek]));
+                    maxErrors[greek] = std::max(maxErrors[greek], error);
+                }
+            }
+        }
+    }
+    std::printf("Black-Scholes Greeks against central differences, max error / (1 + |Greek|)\n");
+    for (int greek = 0; greek < 7; greek++) {
+        std::printf("%-6s %10.2e\n", greekNames[greek], maxErrors[greek]);
+        checkBound(greekNames[greek], maxErrors[greek], 1e-5);
+    }
+    std::printf("\n");
+}
+
+/**
+ * Quotes per second of the implied volatility solver for each instruction set level and on
+ * every hardware thread, with the iterations it took and how far the volatilities it found are
+ * from the ones the quotes were priced with.
+ */
+static void impliedVolatilityBenchmark() {
+    const std::size_t count = 1000000;
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<double> prices(count), stockPrices(count), strikePrices(count), times(count);
+    std::vector<double> intRates(count), volatilities(count), timeValues(count);
+    std::vector<OptionType> types(count);
+    for (std::size_t i = 0; i < count; i++) {
+        stockPrices[i] = 50 + 100 * uniform(generator);
+        volatilities[i] = 0.05 + 0.75 * uniform(generator);
+        strikePrices[i] = stockPrices[i] * (0.5 + uniform(generator));
+        times[i] = 0.02 + 3 * uniform(generator);
+        intRates[i] = 0.08 * uniform(generator);
+        types[i] = uniform(generator) < 0.5 ? OptionType::Call : OptionType::Put;
+        BlackScholes blackScholes(stockPrices[i], volatilities[i], strikePrices[i], times[i],
+                                  intRates[i]);
+        double sign = types[i] == OptionType::Call ? 1 : -1;
+        prices[i] = types[i] == OptionType::Call ? blackScholes.callOptionPrice()
+                                                 : blackScholes.putOptionPrice();
+        double intrinsic = sign * (stockPrices[i] -
+                                   strikePrices[i] * std::exp(-intRates[i] * times[i]));
+        timeValues[i] = prices[i] - std::max(intrinsic, 0.0);
+    }
+
+    std::vector<ImpliedVolatility> results(count);
+    auto report = [&](const char* path, double seconds, double baseSeconds) {
+        double iterations = 0, error = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            iterations += results[i].iterations;
+            // deep in the money quotes whose time value is lost to rounding imply no volatility
+            if (results[i].status == ImpliedVolatilityStatus::Converged &&
+                timeValues[i] > 1e-8 * stockPrices[i]) {
+                error = std::max(error, std::fabs(results[i].volatility - volatilities[i]));
+            }
+        }
+        std::printf("%-14s %12.3e %8.2fx %11.2f %11.2e\n", path, count / seconds,
+                    baseSeconds / seconds, iterations / count, error);
+    };
+
+    std::printf("Implied volatility, %zu quotes, quotes per second\n", count);
+    std::printf("%-14s %12s %9s %11s %11s\n", "path", "quotes/s", "speedup", "iterations",
+                "max error");
+    double scalarSeconds = 0;
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        double seconds = secondsPerRun([&] {
+            impliedVolatilities(prices.data(), stockPrices.data(), strikePrices.data(),
+                                times.data(), intRates.data(), types.data(), count,
+                                results.data());
+        });
+        if (level == SimdLevel::Scalar) {
+            scalarSeconds = seconds;
+        }
+        report(simdLevelName(level), seconds, scalarSeconds);
+    }
+    setSimdLevel(detectSimdLevel());
+
+    ThreadPool pool;
+    char path[32];
+    std::snprintf(path, sizeof(path), "%s x%d", simdLevelName(detectSimdLevel()), pool.size());
+    double seconds = secondsPerRun([&] {
+        impliedVolatilities(prices.data(), stockPrices.data(), strikePrices.data(), times.data(),
+                            intRates.data(), types.data(), count, results.data(), pool);
+    });
+    report(path, seconds, scalarSeconds);
+
+    int statuses[5] = {};
+    const int maxIterationsShown = 6;
+    int iterations[maxIterationsShown + 1] = {};
+    for (const ImpliedVolatility& result : results) {
+        statuses[static_cast<int>(result.status)]++;
+        iterations[std::min(result.iterations, maxIterationsShown)]++;
+    }
+    std::printf("converged %d, invalid input %d, below intrinsic %d, above maximum %d, "
+                "not converged %d\n", statuses[0], statuses[1], statuses[2], statuses[3],
+                statuses[4]);
+    std::printf("iterations:");
+    for (int i = 0; i <= maxIterationsShown; i++) {
+        if (iterations[i] > 0) {
+            std::printf(" %d%s: %d", i, i == maxIterationsShown ? "+" : "", iterations[i]);
+        }
+    }
+    std::printf("\n\n");
+}
+
+/**
+ * Time to fit a volatility surface to a chain of quotes on the calling thread and on every
+ * hardware thread, and the cost of a volatility query on the grid against the SVI slices.
+ */
+static void surfaceBenchmark() {
+    const double stockPrice = 100, intRate = 0.03;
+    const double expiries[] = {0.02, 0.04, 0.08, 0.17, 0.25, 0.5, 0.75, 1, 1.5, 2, 3, 5};
+    std::vector<double> strikePrices, times, prices;
+    std::vector<OptionType> types;
+    for (double time : expiries) {
+        double forward = stockPrice * std::exp(intRate * time);
+        for (double strikePrice = 50; strikePrice <= 150; strikePrice += 1) {
+            // an equity like skew, its total variance growing with time
+            double k = std::log(strikePrice / forward) - 0.02;
+            double variance = 0.03 * time + 0.1 * std::sqrt(time) *
+                                            (-0.6 * k + std::sqrt(k * k + 0.04));
+            BlackScholes blackScholes(stockPrice, std::sqrt(variance / time), strikePrice, time,
+                                      intRate);
+            bool call = strikePrice > forward;
+            strikePrices.push_back(strikePrice);
+            times.push_back(time);
+            prices.push_back(call ? blackScholes.callOptionPrice() : blackScholes.putOptionPrice());
+            types.push_back(call ? OptionType::Call : OptionType::Put);
+        }
+    }
+
+    ThreadPool pool;
+    double serialSeconds = secondsPerRun([&] {
+        VolatilitySurface surface(stockPrice, intRate, strikePrices, times, prices, types);
+        sink = surface.volatility(100, 1);
+    });
+    double pooledSeconds = secondsPerRun([&] {
+        VolatilitySurface surface(stockPrice, intRate, strikePrices, times, prices, types, &pool);
+        sink = surface.volatility(100, 1);
+    });
+    VolatilitySurface surface(stockPrice, intRate, strikePrices, times, prices, types, &pool);
+    double fitError = 0;
+    for (const SviSlice& slice : surface.sviSlices()) {
+        fitError = std::max(fitError, slice.rmsError);
+    }
+
+    const int queries = 1 << 16;
+    std::vector<double> queryStrikes(queries), queryTimes(queries);
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    double gridError = 0;
+    for (int i = 0; i < queries; i++) {
+        queryStrikes[i] = 50 + 100 * uniform(generator);
+        queryTimes[i] = 0.02 + 4.98 * uniform(generator);
+        gridError = std::max(gridError,
+                             std::fabs(surface.volatility(queryStrikes[i], queryTimes[i]) -
+                                       surface.sliceVolatility(queryStrikes[i], queryTimes[i])));
+    }
+    double gridSeconds = secondsPerRun([&] {
+        double total = 0;
+        for (int i = 0; i < queries; i++) {
+            total += surface.volatility(queryStrikes[i], queryTimes[i]);
+        }
+        sink = total;
+    });
+    double sliceSeconds = secondsPerRun([&] {
+        double total = 0;
+        for (int i = 0; i < queries; i++) {
+            total += surface.sliceVolatility(queryStrikes[i], queryTimes[i]);
+        }
+        sink = total;
+    });
+
+    std::printf("Volatility surface, %zu quotes in %zu expiries\n", prices.size(),
+                surface.sviSlices().size());
+    std::printf("fit on 1 thread %.2f ms, on %d thread%s %.2f ms, worst slice rms error %.2e, "
+                "%zu arbitrage violations\n", serialSeconds * 1e3, pool.size(),
+                pool.size() == 1 ? "" : "s", pooledSeconds * 1e3, fitError,
+                surface.arbitrage().size());
+    std::printf("query: grid %.1f ns, SVI slices %.1f ns, grid error %.2e\n\n",
+                gridSeconds / queries * 1e9, sliceSeconds / queries * 1e9, gridError);
+}
+
+/**
+ * Time per price of the classes deriving from Option, called through the virtual interface,
+ * against the templated engines of PricingEngines.h in double and float: the Black-Scholes
+ * formula over a range of strikes, a European call and an American put on a 2000 step binomial
+ * lattice and a European put from a million Monte Carlo paths.
+ */
+static void enginesBenchmark() {
+    const double stockPrice = 100, volatility = 0.2, strikePrice = 105, time = 1, intRate = 0.05;
+    const int strikes = 100000, steps = 2000, simulations = 1000000;
+    std::printf("Virtual Option interface against templated engines\n");
+    std::printf("%-20s %-16s %12s %14s\n", "option", "engine", "us/price", "price");
+    auto report = [](const char* option, const char* engine, double seconds, double price) {
+        std::printf("%-20s %-16s %12.3f %14.8f\n", option, engine, seconds * 1e6, price);
+    };
+
+    std::vector<BlackScholes> objects;
+    for (int i = 0; i < strikes; i++) {
+        objects.emplace_back(stockPrice, volatility, 50 + 100.0 * i / strikes, time, intRate);
+    }
+    double sum = 0;
+    double seconds = secondsPerRun([&] {
+        sum = 0;
+        for (BlackScholes& object : objects) {
+            Option& option = object;
+            sum += option.putOptionPrice();
+        }
+    });
+    report("Black-Scholes put", "Option", seconds / strikes, sum / strikes);
+    seconds = secondsPerRun([&] {
+        sum = 0;
+        for (int i = 0; i < strikes; i++) {
+            sum += BlackScholesEngine<PutPayoff>(stockPrice, volatility, 50 + 100.0 * i / strikes,
+                                                 time, intRate).price();
+        }
+    });
+    report("", "engine<double>", seconds / strikes, sum / strikes);
+    seconds = secondsPerRun([&] {
+        sum = 0;
+        for (int i = 0; i < strikes; i++) {
+            sum += BlackScholesEngine<PutPayoff, float>(stockPrice, volatility,
+                                                        50 + 100.0f * i / strikes, time,
+                                                        intRate).price();
+        }
+    });
+    report("", "engine<float>", seconds / strikes, sum / strikes);
+
+    Binomial europeanLattice(stockPrice, volatility, strikePrice, time, intRate, steps);
+    Binomial americanLattice(stockPrice, volatility, strikePrice, time, intRate, steps,
+                             ExerciseStyle::American);
+    BinomialEngine<CallPayoff, EuropeanExercise> europeanDouble(stockPrice, volatility,
+                                                                strikePrice, time, intRate, steps);
+    BinomialEngine<CallPayoff, EuropeanExercise, float> europeanFloat(stockPrice, volatility,
+                                                                      strikePrice, time, intRate,
+                                                                      steps);
+    BinomialEngine<PutPayoff, AmericanExercise> americanDouble(stockPrice, volatility,
+                                                               strikePrice, time, intRate, steps);
+    BinomialEngine<PutPayoff, AmericanExercise, float> americanFloat(stockPrice, volatility,
+                                                                     strikePrice, time, intRate,
+                                                                     steps);
+    double price = 0;
+    Option& europeanOption = europeanLattice;
+    seconds = secondsPerRun([&] { price = europeanOption.callOptionPrice(); });
+    report("European call, CRR", "Option", seconds, price);
+    seconds = secondsPerRun([&] { price = europeanDouble.price(); });
+    report("", "engine<double>", seconds, price);
+    seconds = secondsPerRun([&] { price = europeanFloat.price(); });
+    report("", "engine<float>", seconds, price);
+    Option& americanOption = americanLattice;
+    seconds = secondsPerRun([&] { price = americanOption.putOptionPrice(); });
+    report("American put, CRR", "Option", seconds, price);
+    seconds = secondsPerRun([&] { price = americanDouble.price(); });
+    report("", "engine<double>", seconds, price);
+    seconds = secondsPerRun([&] { price = americanFloat.price(); });
+    report("", "engine<float>", seconds, price);
+
+    const std::uint64_t seed = 42;
+    MonteCarlo monteCarlo(stockPrice, volatility, strikePrice, time, intRate, simulations, seed);
+    Option& monteCarloOption = monteCarlo;
+    seconds = secondsPerRun([&] { price = monteCarloOption.putOptionPrice(); });
+    report("Monte Carlo put", "Option", seconds, price);
+    seconds = secondsPerRun([&] {
+        price = MonteCarloEngine<PutPayoff>(stockPrice, volatility, strikePrice, time, intRate,
+                                            simulations).price(seed);
+    });
+    report("", "engine<double>", seconds, price);
+    seconds = secondsPerRun([&] {
+        price = MonteCarloEngine<PutPayoff, float>(stockPrice, volatility, strikePrice, time,
+                                                   intRate, simulations).price(seed);
+    });
+    report("", "engine<float>", seconds, price);
+    sink = sum + price;
+    std::printf("\n");
+}
+
+/**
+ * Parameters of a random option for the float benchmarks, drawn in float so that the float and
+ * the double path price exactly the same option.
+ */
+struct RandomOption {
+    float stockPrice, volatility, strikePrice, time, intRate;
+    OptionType type;
+};
+
+/**
+ * Draws stock prices 50 to 150, volatility 5% to 80%, strikes half to one and a half times the
+ * stock price, 0.02 to 3 years and rates up to 8%, and calls and puts in equal numbers.
+ */
+static RandomOption randomOption(std::mt19937_64& generator) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    RandomOption option;
+    option.stockPrice = static_cast<float>(50 + 100 * uniform(generator));
+    option.volatility = static_cast<float>(0.05 + 0.75 * uniform(generator));
+    option.strikePrice = static_cast<float>(option.stockPrice * (0.5 + uniform(generator)));
+    option.time = static_cast<float>(0.02 + 3 * uniform(generator));
+    option.intRate = static_cast<float>(0.08 * uniform(generator));
+    option.type = uniform(generator) < 0.5 ? OptionType::Call : OptionType::Put;
+    return option;
+}
+
+/**
+ * Prints the time per price of a binomial engine in double and in float over a set of options
+ * and the largest difference between the two, which is checked against bound.
+ */
+template<class Payoff, class Exercise>
+static void binomialFloatRow(const char* name, const std::vector<RandomOption>& options,
+                             int steps, double bound) {
+    std::vector<BinomialEngine<Payoff, Exercise>> lattices;
+    std::vector<BinomialEngine<Payoff, Exercise, float>> floatLattices;
+    for (const RandomOption& option : options) {
+        lattices.emplace_back(option.stockPrice, option.volatility, option.strikePrice,
+                              option.time, option.intRate, steps);
+        floatLattices.emplace_back(option.stockPrice, option.volatility, option.strikePrice,
+                                   option.time, option.intRate, steps);
+    }
+    double error = 0;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        error = std::max(error, std::fabs(floatLattices[i].price() - lattices[i].price()));
+    }
+    double doubleSeconds = secondsPerRun([&] {
+        for (auto& lattice : lattices) {
+            sink = lattice.price();
+        }
+    });
+    double floatSeconds = secondsPerRun([&] {
+        for (auto& lattice : floatLattices) {
+            sink = lattice.price();
+        }
+    });
+    std::printf("%-14s %6d %12.1f %12.1f %8.2fx %12.2e\n", name, steps,
+                doubleSeconds / options.size() * 1e6, floatSeconds / options.size() * 1e6,
+                doubleSeconds / floatSeconds, error);
+    char what[64];
+    std::snprintf(what, sizeof(what), "float %s, %d steps", name, steps);
+    checkBound(what, error, bound);
+}
+
+/**
+ * Float against double for each engine over random options. Reports the largest difference
+ * from the double price and the speed of each. Monte Carlo draws different paths in float and
+ * double, so both are compared with the exact price in units of the standard error instead.
+ * Each error is checked against the bound the README gives for it.
+ */
+static void floatBenchmark() {
+    std::mt19937_64 generator(7);
+    const std::size_t count = 1000000;
+    std::vector<double> stockPrices(count), volatilities(count), strikePrices(count),
+            times(count), intRates(count), prices(count);
+    std::vector<float> floatStockPrices(count), floatVolatilities(count),
+            floatStrikePrices(count), floatTimes(count), floatIntRates(count), floatPrices(count);
+    std::vector<OptionType> types(count);
+    for (std::size_t i = 0; i < count; i++) {
+        RandomOption option = randomOption(generator);
+        stockPrices[i] = floatStockPrices[i] = option.stockPrice;
+        volatilities[i] = floatVolatilities[i] = option.volatility;
+        strikePrices[i] = floatStrikePrices[i] = option.strikePrice;
+        times[i] = floatTimes[i] = option.time;
+        intRates[i] = floatIntRates[i] = option.intRate;
+        types[i] = option.type;
+    }
+
+    std::printf("Float against double, Black-Scholes batch, %zu options\n", count);
+    std::printf("%-8s %-5s %14s %14s %9s %12s %12s\n", "level", "tier", "double opt/s",
+                "float opt/s", "speedup", "max error", "error / S");
+    const char* tierNames[] = {"Full", "High", "Fast"};
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        for (NormalAccuracy accuracy : {NormalAccuracy::Full, NormalAccuracy::Fast}) {
+            double doubleSeconds = secondsPerRun([&] {
+                BlackScholesBatch::price(stockPrices.data(), volatilities.data(),
+                                         strikePrices.data(), times.data(), intRates.data(),
+                                         types.data(), count, prices.data(), accuracy);
+            });
+            double floatSeconds = secondsPerRun([&] {
+                BlackScholesBatch::price(floatStockPrices.data(), floatVolatilities.data(),
+                                         floatStrikePrices.data(), floatTimes.data(),
+                                         floatIntRates.data(), types.data(), count,
+                                         floatPrices.data(), accuracy);
+            });
+            BlackScholesBatch::price(stockPrices.data(), volatilities.data(), strikePrices.data(),
+                                     times.data(), intRates.data(), types.data(), count,
+                                     prices.data());
+            double error = 0, relativeError = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                double difference = std::fabs(floatPrices[i] - prices[i]);
+                error = std::max(error, difference);
+                relativeError = std::max(relativeError, difference / stockPrices[i]);
+            }
+            std::printf("%-8s %-5s %14.3e %14.3e %8.2fx %12.2e %12.2e\n", simdLevelName(level),
+                        tierNames[static_cast<int>(accuracy)], count / doubleSeconds,
+                        count / floatSeconds, doubleSeconds / floatSeconds, error,
+                        relativeError);
+            char what[64];
+            std::snprintf(what, sizeof(what), "float batch, %s %s", simdLevelName(level),
+                          tierNames[static_cast<int>(accuracy)]);
+            checkBound(what, error, accuracy == NormalAccuracy::Fast ? 8e-5 : 4e-5);
+        }
+    }
+    setSimdLevel(detectSimdLevel());
+
+    std::vector<RandomOption> options(100);
+    for (RandomOption& option : options) {
+        option = randomOption(generator);
+    }
+    std::printf("\nFloat against double, binomial engine, %zu options\n", options.size());
+    std::printf("%-14s %6s %12s %12s %9s %12s\n", "option", "steps", "double us", "float us",
+                "speedup", "max error");
+    for (int steps : {500, 2000}) {
+        binomialFloatRow<CallPayoff, EuropeanExercise>("European call", options, steps,
+                                                       steps <= 500 ? 1e-4 : 1e-3);
+        binomialFloatRow<PutPayoff, AmericanExercise>("American put", options, steps, 1e-4);
+    }
+
+    const int simulations = 1000000;
+    const int monteCarloOptions = 10;
+    std::printf("\nFloat against double, Monte Carlo engine, %d European calls, %d paths\n",
+                monteCarloOptions, simulations);
+    std::printf("%-8s %12s %22s\n", "type", "ms/price", "max |error| / std err");
+    std::default_random_engine paths(42);
+    double doubleSeconds = 0, floatSeconds = 0, doubleDeviations = 0, floatDeviations = 0;
+    for (int n = 0; n < monteCarloOptions; n++) {
+        const RandomOption& option = options[n];
+        double exact = BlackScholesEngine<CallPayoff>(option.stockPrice, option.volatility,
+                                                      option.strikePrice, option.time,
+                                                      option.intRate).price();
+        // standard error of the estimate from the variance of the discounted payoff
+        std::normal_distribution<double> normal(0, 1);
+        double deviation = option.volatility * std::sqrt(static_cast<double>(option.time));
+        double drift = option.intRate * option.time - 0.5 * deviation * deviation;
+        double discount = std::exp(-option.intRate * option.time);
+        double sum = 0, sumSquares = 0;
+        for (int i = 0; i < simulations; i++) {
+            double stockPrice = option.stockPrice * std::exp(drift + deviation * normal(paths));
+            double payoff = discount * std::max(stockPrice - option.strikePrice, 0.0);
+            sum += payoff;
+            sumSquares += payoff * payoff;
+        }
+        double mean = sum / simulations;
+        double standardError = std::sqrt((sumSquares / simulations - mean * mean) / simulations);
+
+        MonteCarloEngine<CallPayoff> engine(option.stockPrice, option.volatility,
+                                            option.strikePrice, option.time, option.intRate,
+                                            simulations);
+        MonteCarloEngine<CallPayoff, float> floatEngine(option.stockPrice, option.volatility,
+                                                        option.strikePrice, option.time,
+                                                        option.intRate, simulations);
+        double price = 0, floatPrice = 0;
+        doubleSeconds += secondsPerRun([&] { price = engine.price(paths); });
+        floatSeconds += secondsPerRun([&] { floatPrice = floatEngine.price(paths); });
+        doubleDeviations = std::max(doubleDeviations, std::fabs(price - exact) / standardError);
+        floatDeviations = std::max(floatDeviations, std::fabs(floatPrice - exact) / standardError);
+    }
+    std::printf("%-8s %12.1f %22.2f\n", "double", doubleSeconds / monteCarloOptions * 1e3,
+                doubleDeviations);
+    std::printf("%-8s %12.1f %22.2f\n\n", "float", floatSeconds / monteCarloOptions * 1e3,
+                floatDeviations);
+    checkBound("float Monte Carlo, standard errors", floatDeviations, 4);
+}
+
+/**
+ * Spot ticks of a book of options on one stock: one BlackScholes object per option and
+ * BlackScholesBatch against BlackScholesBook, in full and with the delta and gamma path at a
+ * few tolerances. The stock follows a random walk of 1e-4 relative steps, about what one tick
+ * moves a liquid stock. Errors are against the BlackScholes objects on every tenth tick.
+ */
+static void bookBenchmark() {
+    const std::size_t count = 10000;
+    const int ticks = 1000;
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> volatilities(count), strikePrices(count), times(count), intRates(count);
+    std::vector<OptionType> types(count);
+    for (std::size_t i = 0; i < count; i++) {
+        volatilities[i] = 0.05 + 0.75 * uniform(generator);
+        strikePrices[i] = 100 * (0.5 + uniform(generator));
+        times[i] = 0.02 + 3 * uniform(generator);
+        intRates[i] = 0.08 * uniform(generator);
+        types[i] = uniform(generator) < 0.5 ? OptionType::Call : OptionType::Put;
+    }
+    std::vector<double> stockPrices(ticks);
+    double walk = 100;
+    for (double& stockPrice : stockPrices) {
+        walk *= 1 + 1e-4 * normal(generator);
+        stockPrice = walk;
+    }
+
+    std::vector<std::vector<double>> expected;
+    for (int t = 0; t < ticks; t += 10) {
+        std::vector<double> row(count);
+        for (std::size_t i = 0; i < count; i++) {
+            BlackScholes option(stockPrices[t], volatilities[i], strikePrices[i], times[i],
+                                intRates[i]);
+            row[i] = types[i] == OptionType::Call ? option.callOptionPrice()
+                                                  : option.putOptionPrice();
+        }
+        expected.push_back(row);
+    }
+
+    std::printf("Black-Scholes book, %zu options on one stock, %d ticks\n", count, ticks);
+    std::printf("%-16s %12s %9s %12s %12s\n", "path", "ticks/s", "speedup", "repriced",
+                "max error");
+    double objectSeconds = secondsPerRun([&] {
+        for (int t = 0; t < ticks; t++) {
+            double total = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                BlackScholes option(stockPrices[t], volatilities[i], strikePrices[i], times[i],
+                                    intRates[i]);
+                total += types[i] == OptionType::Call ? option.callOptionPrice()
+                                                      : option.putOptionPrice();
+            }
+            sink = total;
+        }
+    });
+    std::printf("%-16s %12.1f %9s %11.1f%% %12s\n", "per object", ticks / objectSeconds, "1.00x",
+                100.0, "-");
+
+    std::vector<double> spots(count), prices(count);
+    double batchSeconds = secondsPerRun([&] {
+        for (int t = 0; t < ticks; t++) {
+            std::fill(spots.begin(), spots.end(), stockPrices[t]);
+            BlackScholesBatch::price(spots.data(), volatilities.data(), strikePrices.data(),
+                                     times.data(), intRates.data(), types.data(), count,
+                                     prices.data());
+            sink = prices[0];
+        }
+    });
+    std::printf("%-16s %12.1f %8.2fx %11.1f%% %12s\n", "batch", ticks / batchSeconds,
+                objectSeconds / batchSeconds, 100.0, "-");
+
+    for (double tolerance : {0.0, 0.01, 0.05, 0.2}) {
+        BlackScholesBook book;
+        book.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            book.addOption(volatilities[i], strikePrices[i], times[i], intRates[i], types[i]);
+        }
+        book.setTaylorTolerance(tolerance);
+        std::size_t repriced = 0;
+        double seconds = secondsPerRun([&] {
+            repriced = 0;
+            for (int t = 0; t < ticks; t++) {
+                sink = book.tick(stockPrices[t])[0];
+                repriced += book.fullyRepriced();
+            }
+        });
+
+        double error = 0;
+        for (int t = 0; t < ticks; t++) {
+            const std::vector<double>& bookPrices = book.tick(stockPrices[t]);
+            if (t % 10 == 0) {
+                for (std::size_t i = 0; i < count; i++) {
+                    error = std::max(error, std::fabs(bookPrices[i] - expected[t / 10][i]));
+                }
+            }
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), tolerance > 0 ? "book, tol %.2f" : "book, full",
+                      tolerance);
+        std::printf("%-16s %12.1f %8.2fx %11.1f%% %12.2e\n", name, ticks / seconds,
+                    objectSeconds / seconds, 100.0 * repriced / (double(ticks) * count), error);
+    }
+    std::printf("\n");
+}
+
+/**
+ * BlackScholesGrid at a few sizes against the formula of BlackScholes on a million random
+ * options: how long the grid takes to build, save and load, the nanoseconds per price, its
+ * error bound and the largest error found, both relative to the stock price, and the share of
+ * options outside the grid that fall back to the formula.
+ */
+static void gridBenchmark() {
+    const std::size_t count = 1000000;
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<double> stockPrices(count), volatilities(count), strikePrices(count),
+            times(count), intRates(count), expected(count);
+    std::vector<OptionType> types(count);
+    for (std::size_t i = 0; i < count; i++) {
+        stockPrices[i] = 50 + 100 * uniform(generator);
+        volatilities[i] = 0.05 + 0.75 * uniform(generator);
+        strikePrices[i] = stockPrices[i] * (0.5 + uniform(generator));
+        times[i] = 0.02 + 3 * uniform(generator);
+        intRates[i] = 0.08 * uniform(generator);
+        types[i] = uniform(generator) < 0.5 ? OptionType::Call : OptionType::Put;
+    }
+    double formulaSeconds = secondsPerRun([&] {
+        for (std::size_t i = 0; i < count; i++) {
+            BlackScholes option(stockPrices[i], volatilities[i], strikePrices[i], times[i],
+                                intRates[i]);
+            expected[i] = types[i] == OptionType::Call ? option.callOptionPrice()
+                                                       : option.putOptionPrice();
+        }
+    });
+
+    std::printf("Black-Scholes grid, %zu options\n", count);
+    std::printf("%-9s %9s %9s %9s %8s %9s %11s %11s %9s\n", "grid", "build ms", "save ms",
+                "load ms", "ns/price", "speedup", "bound / S", "error / S", "fallback");
+    std::printf("%-9s %9s %9s %9s %8.1f %9s %11s %11s %9s\n", "formula", "-", "-", "-",
+                formulaSeconds * 1e9 / count, "1.00x", "-", "-", "-");
+    const char* path = "optionsBench.grid";
+    for (int points : {51, 101, 201, 401}) {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+        BlackScholesGrid built(points, points);
+        Clock::time_point builtAt = Clock::now();
+        built.save(path);
+        Clock::time_point savedAt = Clock::now();
+        BlackScholesGrid grid(path);
+        Clock::time_point loadedAt = Clock::now();
+        std::remove(path);
+
+        std::vector<double> prices(count);
+        double seconds = secondsPerRun([&] {
+            for (std::size_t i = 0; i < count; i++) {
+                prices[i] = grid.price(stockPrices[i], volatilities[i], strikePrices[i], times[i],
+                                       intRates[i], types[i]);
+            }
+        });
+        double error = 0;
+        std::size_t fallbacks = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            error = std::max(error, std::fabs(prices[i] - expected[i]) / stockPrices[i]);
+            double deviation = volatilities[i] * std::sqrt(times[i]);
+            double moneyness = (std::log(strikePrices[i] / stockPrices[i]) -
+                                intRates[i] * times[i]) / deviation;
+            fallbacks += grid.covers(moneyness, deviation) ? 0 : 1;
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "%dx%d", points, points);
+        auto ms = [](Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        };
+        std::printf("%-9s %9.1f %9.1f %9.1f %8.1f %8.2fx %11.2e %11.2e %8.1f%%\n", name,
+                    ms(start, builtAt), ms(builtAt, savedAt), ms(savedAt, loadedAt),
+                    seconds * 1e9 / count, formulaSeconds / seconds, grid.errorBound(), error,
+                    100.0 * fallbacks / count);
+    }
+    std::printf("\n");
+}
+
+/**
+ * Strong scaling of the Philox Monte Carlo: the same ten million paths on 1, 2, 4, ... threads
+ * up to the hardware's, with the speedup and parallel efficiency over one thread and whether
+ * the estimate is bit for bit the single thread one. The first row is the sequential engine
+ * on std::default_random_engine.
+ */
+static void scalingBenchmark() {
+    const double stockPrice = 100, volatility = 0.25, strikePrice = 105, time = 1, intRate = 0.04;
+    const int simulations = 10000000;
+    const std::uint64_t seed = 42;
+    MonteCarloEngine<CallPayoff> engine(stockPrice, volatility, strikePrice, time, intRate,
+                                        simulations);
+
+    std::printf("Monte Carlo strong scaling, %d paths\n", simulations);
+    std::printf("%-14s %10s %9s %11s %22s %10s\n", "threads", "ms", "speedup", "efficiency",
+                "price", "identical");
+    double stdSeconds = secondsPerRun([&] {
+        std::default_random_engine generator(seed);
+        sink = engine.price(generator);
+    });
+    std::printf("%-14s %10.1f %9s %11s %22s %10s\n", "std engine", stdSeconds * 1e3, "-", "-",
+                "-", "-");
+
+    double singleSeconds = 0;
+    double singlePrice = 0;
+    int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; ; threads = std::min(2 * threads, hardwareThreads)) {
+        ThreadPool pool(threads);
+        double price = 0;
+        double seconds = secondsPerRun([&] { price = engine.price(seed, &pool); });
+        if (threads == 1) {
+            singleSeconds = seconds;
+            singlePrice = price;
+        }
+        char name[16];
+        std::snprintf(name, sizeof(name), "%d", threads);
+        std::printf("%-14s %10.1f %8.2fx %10.1f%% %22.17g %10s\n", name, seconds * 1e3,
+                    singleSeconds / seconds, 100 * singleSeconds / seconds / threads, price,
+                    price == singlePrice ? "yes" : "no");
+        if (threads == hardwareThreads) {
+            break;
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Variance reduction of the Monte Carlo engine on a million paths for a few calls and puts:
+ * the standard error each method achieves, its error against BlackScholes in standard errors,
+ * the effective speedup in paths it reports and the speedup in time to the same standard
+ * error, which also counts what each path costs.
+ */
+static void varianceBenchmark() {
+    const int simulations = 1000000;
+    const std::uint64_t seed = 42;
+    struct Case {
+        const char* name;
+        double strikePrice;
+        OptionType type;
+    };
+    const Case cases[] = {{"ATM call", 100, OptionType::Call}, {"OTM call", 130, OptionType::Call},
+                          {"ITM call", 80, OptionType::Call}, {"OTM put", 80, OptionType::Put}};
+    const VarianceReduction reductions[] = {VarianceReduction::None, VarianceReduction::Antithetic,
+                                            VarianceReduction::ControlVariate,
+                                            VarianceReduction::AntitheticControlVariate};
+    const char* reductionNames[] = {"crude", "antithetic", "control", "both"};
+    const double stockPrice = 100, volatility = 0.25, time = 1, intRate = 0.04;
+
+    std::printf("Monte Carlo variance reduction, %d paths\n", simulations);
+    std::printf("%-9s %-11s %10s %10s %9s %8s %10s %10s\n", "option", "method", "price",
+                "std err", "err/se", "ms", "paths x", "time x");
+    for (const Case& option : cases) {
+        BlackScholes blackScholes(stockPrice, volatility, option.strikePrice, time, intRate);
+        double exact = option.type == OptionType::Call ? blackScholes.callOptionPrice()
+                                                       : blackScholes.putOptionPrice();
+        MonteCarlo monteCarlo(stockPrice, volatility, option.strikePrice, time, intRate,
+                              simulations, seed);
+        double crudeCost = 0;
+        for (int k = 0; k < 4; k++) {
+            monteCarlo.setVarianceReduction(reductions[k]);
+            MonteCarloEstimate estimate{};
+            double seconds = secondsPerRun([&] { estimate = monteCarlo.estimate(option.type); });
+            // the cost of the standard error, time times variance, is what a method saves
+            double cost = seconds * estimate.standardError * estimate.standardError;
+            crudeCost = k == 0 ? cost : crudeCost;
+            std::printf("%-9s %-11s %10.5f %10.2e %9.2f %8.1f %9.1fx %9.1fx\n", option.name,
+                        reductionNames[k], estimate.price, estimate.standardError,
+                        (estimate.price - exact) / estimate.standardError, seconds * 1e3,
+                        estimate.effectiveSpeedup, crudeCost / cost);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Randomized quasi-Monte Carlo against crude Monte Carlo, at growing numbers of paths split
+ * between 16 scrambles: a European call, checked against BlackScholes, and an Asian call
+ * averaging 12 monthly prices. Crude Monte Carlo's standard error at the same paths comes from
+ * the spread of the quasi-random paths themselves, and the order is how fast the standard
+ * error falls, 0.5 for crude Monte Carlo and up to 1 for quasi-Monte Carlo.
+ */
+static void quasiMonteCarloBenchmark() {
+    const std::uint64_t seed = 42;
+    const double stockPrice = 100, volatility = 0.25, strikePrice = 100, time = 1, intRate = 0.04;
+    const double exact = BlackScholes(stockPrice, volatility, strikePrice, time, intRate)
+            .callOptionPrice();
+
+    std::printf("Quasi-Monte Carlo with scrambled Sobol points, 16 replicates\n");
+    std::printf("%-8s %8s %10s %10s %10s %9s %7s %9s %8s\n", "option", "paths", "price",
+                "std err", "crude err", "err/se", "order", "paths x", "ms");
+    for (int dates : {1, 12}) {
+        double previousError = 0;
+        for (int paths = 1 << 12; paths <= 1 << 20; paths <<= 2) {
+            QuasiMonteCarlo quasiMonteCarlo(stockPrice, volatility, strikePrice, time, intRate,
+                                            paths, seed);
+            MonteCarloEstimate estimate{};
+            double seconds = secondsPerRun([&] {
+                estimate = quasiMonteCarlo.asianEstimate(OptionType::Call, dates);
+            });
+            double crudeError = estimate.standardError * std::sqrt(estimate.effectiveSpeedup);
+            double order = previousError > 0
+                    ? std::log(previousError / estimate.standardError) / std::log(4.0)
+                    : 0;
+            previousError = estimate.standardError;
+            std::printf("%-8s %8d %10.6f %10.2e %10.2e ", dates == 1 ? "European" : "Asian",
+                        paths, estimate.price, estimate.standardError, crudeError);
+            if (dates == 1) {
+                std::printf("%9.2f ", (estimate.price - exact) / estimate.standardError);
+            } else {
+                std::printf("%9s ", "-");
+            }
+            std::printf("%7.2f %8.0fx %8.1f\n", order, estimate.effectiveSpeedup,
+                        seconds * 1e3);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Path dependent options on the block engine, each checked against an independent price: the
+ * Asian call against quasi-Monte Carlo, the down-and-out call against the continuous barrier
+ * formula at the barrier Broadie, Glasserman and Kou shift for discrete monitoring, with the
+ * down-and-in call adding up to the vanilla BlackScholes price, and the floating lookback call
+ * against the continuous formula of Goldman, Sosin and Gatto, which the discrete option
+ * approaches from below as the steps get finer. Then the path steps per second of each
+ * instruction set, for the Asian call.
+ */
+static void pathDependentBenchmark() {
+    const std::uint64_t seed = 42;
+    const int simulations = 200000;
+    const double stockPrice = 100, volatility = 0.25, strikePrice = 100, time = 1, intRate = 0.04;
+    const double barrier = 90;
+    auto call = [&](double spot, double strike) {
+        return BlackScholes(spot, volatility, strike, time, intRate).callOptionPrice();
+    };
+    auto printRow = [](const char* name, int steps, const MonteCarloEstimate& estimate,
+                       double reference, double seconds) {
+        std::printf("%-14s %6d %10.5f %10.2e %10.5f %8.2f %8.1f\n", name, steps, estimate.price,
+                    estimate.standardError, reference,
+                    (estimate.price - reference) / estimate.standardError, seconds * 1e3);
+    };
+
+    std::printf("Path dependent Monte Carlo, %d paths in blocks of %zu\n", simulations,
+                PathDependentEngine<AsianAccumulator<CallPayoff>>::blockPaths);
+    std::printf("%-14s %6s %10s %10s %10s %8s %8s\n", "option", "steps", "price", "std err",
+                "reference", "err/se", "ms");
+    MonteCarloEstimate estimate{};
+    double seconds = 0;
+
+    PathDependentEngine<AsianAccumulator<CallPayoff>> asian(
+            stockPrice, volatility, time, intRate, 12, simulations,
+            AsianAccumulator<CallPayoff>(strikePrice));
+    seconds = secondsPerRun([&] { estimate = asian.estimate(seed); });
+    QuasiMonteCarlo quasiMonteCarlo(stockPrice, volatility, strikePrice, time, intRate, 1 << 20,
+                                    seed);
+    printRow("Asian call", 12, estimate,
+             quasiMonteCarlo.asianEstimate(OptionType::Call, 12).price, seconds);
+
+    for (int steps : {12, 52, 252}) {
+        // the continuous down-and-out call, C(S) - (H / S)^(2r / vol^2 - 1) C(H^2 / S)
+        double shifted = barrier * std::exp(-0.5826 * volatility * std::sqrt(time / steps));
+        double power = 2 * intRate / (volatility * volatility) - 1;
+        double continuous = call(stockPrice, strikePrice) -
+                            std::pow(shifted / stockPrice, power) *
+                            call(shifted * shifted / stockPrice, strikePrice);
+        PathDependentEngine<BarrierAccumulator<CallPayoff, BarrierType::DownAndOut>> out(
+                stockPrice, volatility, time, intRate, steps, simulations,
+                BarrierAccumulator<CallPayoff, BarrierType::DownAndOut>(strikePrice, barrier));
+        seconds = secondsPerRun([&] { estimate = out.estimate(seed); });
+        printRow("down-out call", steps, estimate, continuous, seconds);
+        double outPrice = estimate.price;
+        PathDependentEngine<BarrierAccumulator<CallPayoff, BarrierType::DownAndIn>> in(
+                stockPrice, volatility, time, intRate, steps, simulations,
+                BarrierAccumulator<CallPayoff, BarrierType::DownAndIn>(strikePrice, barrier));
+        estimate = in.estimate(seed);
+        std::printf("%-14s %6d %10.5f %10s %10.5f %8s\n", "in + out", steps,
+                    estimate.price + outPrice, "-", call(stockPrice, strikePrice), "-");
+    }
+
+    // the continuous floating strike lookback call with the minimum so far at the stock price
+    const double deviation = volatility * std::sqrt(time);
+    const double a1 = (intRate + 0.5 * volatility * volatility) * time / deviation;
+    const double a3 = (-intRate + 0.5 * volatility * volatility) * time / deviation;
+    const double ratio = volatility * volatility / (2 * intRate);
+    const double lookback = stockPrice * (normalCdf(a1) - ratio * normalCdf(-a1)) -
+                            stockPrice * std::exp(-intRate * time) *
+                            (normalCdf(a1 - deviation) - ratio * normalCdf(-a3));
+    for (int steps : {12, 52, 252}) {
+        PathDependentEngine<LookbackAccumulator<CallPayoff>> engine(
+                stockPrice, volatility, time, intRate, steps, simulations,
+                LookbackAccumulator<CallPayoff>());
+        seconds = secondsPerRun([&] { estimate = engine.estimate(seed); });
+        printRow("lookback call", steps, estimate, lookback, seconds);
+    }
+
+    std::printf("\n%-10s %16s\n", "level", "path steps/s");
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        PathDependentEngine<AsianAccumulator<CallPayoff>> engine(
+                stockPrice, volatility, time, intRate, 52, simulations,
+                AsianAccumulator<CallPayoff>(strikePrice));
+        seconds = secondsPerRun([&] { estimate = engine.estimate(seed); });
+        std::printf("%-10s %16.3e\n", simdLevelName(level), 52.0 * simulations / seconds);
+    }
+    setSimdLevel(detectSimdLevel());
+    std::printf("\n");
+}
+
+/**
+ * Least squares Monte Carlo against the binomial lattice for American puts: the lattice of
+ * 2000 steps prices both the Bermudan option exercisable on the same 50 dates, the like for
+ * like check, and the American option. Then the ATM put with each degree of the regression
+ * polynomial.
+ */
+static void longstaffSchwartzBenchmark() {
+    const int simulations = 1 << 17;
+    const int exerciseDates = 50, latticeSteps = 2000;
+    const double stockPrice = 100, volatility = 0.25, time = 1, intRate = 0.04;
+    std::vector<double> dates;
+    for (int k = 1; k <= exerciseDates; k++) {
+        dates.push_back(time * k / exerciseDates);
+    }
+
+    std::printf("Least squares Monte Carlo, %d paths, %d exercise dates, %.0f MB of paths\n",
+                simulations, exerciseDates,
+                (exerciseDates - 1.0) * simulations * sizeof(float) / (1 << 20));
+    std::printf("%-7s %6s %10s %10s %10s %8s %10s %8s\n", "strike", "degree", "LSM", "std err",
+                "Bermudan", "err/se", "American", "ms");
+    for (double strikePrice : {90.0, 100.0, 110.0}) {
+        Binomial bermudan(stockPrice, volatility, strikePrice, time, intRate, latticeSteps, dates);
+        Binomial american(stockPrice, volatility, strikePrice, time, intRate, latticeSteps,
+                          ExerciseStyle::American);
+        double bermudanPrice = bermudan.putOptionPrice();
+        double americanPrice = american.putOptionPrice();
+        for (int degree = 1; degree <= 5; degree++) {
+            if (strikePrice != 100 && degree != 3) {
+                continue;
+            }
+            MonteCarlo monteCarlo(stockPrice, volatility, strikePrice, time, intRate, simulations,
+                                  42);
+            MonteCarloEstimate estimate{};
+            double seconds = secondsPerRun([&] {
+                estimate = monteCarlo.americanEstimate(OptionType::Put, exerciseDates, degree);
+            });
+            std::printf("%-7.0f %6d %10.5f %10.2e %10.5f %8.2f %10.5f %8.1f\n", strikePrice,
+                        degree, estimate.price, estimate.standardError, bermudanPrice,
+                        (estimate.price - bermudanPrice) / estimate.standardError, americanPrice,
+                        seconds * 1e3);
+        }
+    }
+    std::printf("\n");
+}
+
+/**
+ * Normal numbers per second from Philox::normals at each instruction set, filling a buffer of
+ * 4096 paths per call as the Monte Carlo engines do, against std::normal_distribution over
+ * std::default_random_engine one draw at a time, and the largest difference from the scalar
+ * kernel's numbers.
+ */
+static void normalGeneratorBenchmark() {
+    const std::size_t count = 4096;
+    const Philox philox(42);
+    std::vector<double> reference(count), normals(count);
+    setSimdLevel(SimdLevel::Scalar);
+    philox.normals(0, count, 0, reference.data());
+
+    std::printf("Normal numbers, %zu per call\n", count);
+    std::printf("%-22s %14s %12s\n", "generator", "normals/s", "max diff");
+    std::default_random_engine engine(42);
+    std::normal_distribution<double> distribution(0, 1);
+    double seconds = secondsPerRun([&] {
+        for (double& normal : normals) {
+            normal = distribution(engine);
+        }
+    });
+    std::printf("%-22s %14.3e %12s\n", "std::normal_distribution", count / seconds, "-");
+    for (SimdLevel level : availableSimdLevels()) {
+        setSimdLevel(level);
+        std::uint32_t draw = 0;
+        seconds = secondsPerRun([&] { philox.normals(0, count, draw++, normals.data()); });
+        philox.normals(0, count, 0, normals.data());
+        double difference = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            difference = std::max(difference, std::fabs(normals[i] - reference[i]));
+        }
+        std::printf("Philox %-15s %14.3e %12.2e\n", simdLevelName(level), count / seconds,
+                    difference);
+    }
+    setSimdLevel(detectSimdLevel());
+    std::printf("\n");
+}
+
+/**
+ * A strip of nine calls and puts on a million paths, priced one simulation per option with
+ * seeds of their own as MonteCarlo used to, and in one pass over shared paths by
+ * MonteCarloStripEngine, crude and with the control variate. Parity is the largest
+ * |call - put - (S - K e^(-rT))| over the strikes, compared with the standard errors.
+ */
+static void fusedMonteCarloBenchmark() {
+    const int simulations = 1000000;
+    const double stockPrice = 100, volatility = 0.25, time = 1, intRate = 0.04;
+    std::vector<double> strikePrices;
+    for (double strikePrice = 80; strikePrice <= 120; strikePrice += 5) {
+        strikePrices.push_back(strikePrice);
+    }
+    auto parityError = [&](const std::vector<CallPutEstimate>& estimates) {
+        double error = 0;
+        for (std::size_t k = 0; k < estimates.size(); k++) {
+            double parity = stockPrice - strikePrices[k] * std::exp(-intRate * time);
+            error = std::max(error, std::fabs(estimates[k].call.price - estimates[k].put.price -
+                                              parity));
+        }
+        return error;
+    };
+
+    std::printf("Monte Carlo strip of %zu strikes, %d paths\n", strikePrices.size(), simulations);
+    std::printf("%-22s %10s %12s %12s\n", "method", "ms", "parity err", "call se");
+    std::vector<CallPutEstimate> estimates;
+    double separateSeconds = secondsPerRun([&] {
+        estimates.clear();
+        std::uint64_t seed = 1;
+        for (double strikePrice : strikePrices) {
+            MonteCarlo call(stockPrice, volatility, strikePrice, time, intRate, simulations,
+                            seed++);
+            MonteCarlo put(stockPrice, volatility, strikePrice, time, intRate, simulations,
+                           seed++);
+            estimates.push_back({call.estimate(OptionType::Call), put.estimate(OptionType::Put)});
+        }
+    });
+    std::printf("%-22s %10.1f %12.2e %12.2e\n", "separate simulations", separateSeconds * 1e3,
+                parityError(estimates), estimates[4].call.standardError);
+
+    const VarianceReduction reductions[] = {VarianceReduction::None,
+                                            VarianceReduction::ControlVariate};
+    const char* names[] = {"fused", "fused, control"};
+    for (int i = 0; i < 2; i++) {
+        MonteCarloStripEngine engine(stockPrice, volatility, time, intRate, simulations);
+        double seconds = secondsPerRun([&] {
+            estimates = engine.estimate(strikePrices, 42, reductions[i]);
+        });
+        std::printf("%-22s %10.1f %12.2e %12.2e %6.1fx\n", names[i], seconds * 1e3,
+                    parityError(estimates), estimates[4].call.standardError,
+                    separateSeconds / seconds);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+    const Benchmark benchmarks[] = {
+            {"lattice", latticeBenchmark},
+            {"chain", chainBenchmark},
+            {"convergence", convergenceBenchmark},
+            {"bbsr", smoothingBenchmark},
+            {"trinomial", trinomialBenchmark},
+            {"greeks", greeksBenchmark},
+            {"blackscholes", blackScholesBenchmark},
+            {"normal", normalBenchmark},
+            {"bsgreeks", analyticGreeksBenchmark},
+            {"impliedvol", impliedVolatilityBenchmark},
+            {"surface", surfaceBenchmark},
+            {"engines", enginesBenchmark},
+            {"float", floatBenchmark},
+            {"book", bookBenchmark},
+            {"grid", gridBenchmark},
+            {"scaling", scalingBenchmark},
+            {"variance", varianceBenchmark},
+            {"qmc", quasiMonteCarloBenchmark},
+            {"paths", pathDependentBenchmark},
+            {"lsm", longstaffSchwartzBenchmark},
+            {"rng", normalGeneratorBenchmark},
+            {"fused", fusedMonteCarloBenchmark},
+    };
+
+    for (const Benchmark& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+        }
+        if (selected) {
+            benchmark.run();
+        }
+    }
+    return failedChecks == 0 ? 0 : 1;
+}
@@ -49,12 +49,30 @@ int main() {
     }
 
     else if (choice == 2) {
-        std::cout << "Enter the number of steps for the binomial option pricer tree (Perferably "
-                     "less than 5): ";
+        std::cout << "Enter the number of steps for the binomial option pricer tree (thousands of "
+                     "steps are fine): ";
         std::cin >> steps;
-        Binomial binomial(stockPrice, volatility, strikePrice, time, intRate, steps);
-        std::cout << "Call Option Price: " << binomial.callOptionPrice() << std::endl;
-        std::cout << "Put Option Price: " << binomial.putOptionPrice() << std::endl;
+        std::cout << std::endl;
+        if (steps < 1) {
+            std::cout << "Invalid Number of Steps Exiting...";
+            return -1;
+        }
+
+        int exercise = 0;
+        std::cout << "Enter the exercise style (1. European, 2. American): ";
+        std::cin >> exercise;
+        std::cout << std::endl;
+        if (exercise < 1 || exercise > 2) {
+            std::cout << "Invalid Exercise Style Exiting...";
+            return -1;
+        }
+        ExerciseStyle exerciseStyle = exercise == 2 ? ExerciseStyle::American
+                                                    : ExerciseStyle::European;
+
+        Binomial binomial(stockPrice, volatility, strikePrice, time, intRate, steps, exerciseStyle);
+        CallPut prices = binomial.callPutPrice();
+        std::cout << "Call Option Price: " << prices.call << std::endl;
+        std::cout << "Put Option Price: " << prices.put << std::endl;
     }
 
     else if (choice == 3) {
@@ -62,7 +80,8 @@ int main() {
                      " the more simulations the more accurate the price will be: ";
         std::cin >> simulations;
         MonteCarlo mc(stockPrice, volatility, strikePrice, time, intRate, simulations);
-        std::cout << "Call Option Price: " << mc.callOptionPrice() << std::endl;
-        std::cout << "Put Option Price: " << mc.putOptionPrice() << std::endl;
+        CallPut prices = mc.callPutPrice();
+        std::cout << "Call Option Price: " << prices.call << std::endl;
+        std::cout << "Put Option Price: " << prices.put << std::endl;
     }
 }
\ No newline at end of file